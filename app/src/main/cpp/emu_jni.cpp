@@ -117,6 +117,36 @@ extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_stopEmulation(J
     return true;
 }
 
+extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_saveState(JNIEnv *, jobject) {
+    auto os{OsWeak.lock()};
+    if (!os || !os->state.process)
+        return false;
+
+    try {
+        auto statistics{os->snapshot.Save(os->state)};
+        os->state.logger->Info("Saved state: {} blocks ({} changed), {} KiB compressed to {} KiB", statistics.blockCount, statistics.compressedBlockCount, statistics.uncompressedSize / 1024, statistics.compressedSize / 1024);
+        return true;
+    } catch (const std::exception &e) {
+        os->state.logger->Error("Failed to save state: {}", e.what());
+        return false;
+    }
+}
+
+extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_loadState(JNIEnv *, jobject) {
+    auto os{OsWeak.lock()};
+    if (!os || !os->state.process)
+        return false;
+
+    try {
+        os->snapshot.Restore(os->state);
+        os->state.logger->Info("Loaded state");
+        return true;
+    } catch (const std::exception &e) {
+        os->state.logger->Error("Failed to load state: {}", e.what());
+        return false;
+    }
+}
+
 extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_setSurface(JNIEnv *, jobject, jobject surface) {
     auto gpu{GpuWeak.lock()};
     if (!gpu)
@@ -123,6 +123,7 @@ namespace skyline {
         // Time
         constexpr u64 NsInSecond{1000000000}; //!< The amount of nanoseconds in a second
         constexpr u64 NsInMillisecond{1000000}; //!< The amount of nanoseconds in a millisecond
+        constexpr u64 NsInMicrosecond{1000}; //!< The amount of nanoseconds in a microsecond
         constexpr u64 NsInDay{86400000000000UL}; //!< The amount of nanoseconds in a day
     }
 
@@ -12,10 +12,13 @@ namespace skyline {
     class Settings {
       public:
         Logger::LogLevel logLevel; //!< The minimum level that logs need to be for them to be printed
+        bool profileSvcs; //!< If the latency of SVCs should be recorded and logged when the process exits
         std::string username; //!< The name set by the user to be supplied to the guest
         bool operationMode; //!< If the emulated Switch should be handheld or docked
         bool forceTripleBuffering; //!< If the presentation engine should always triple buffer even if the swapchain supports double buffering
         bool disableFrameThrottling; //!< Allow the guest to submit frames without any blocking calls
+        bool hostLibcRoutines; //!< If hot guest libc routines should be replaced with their host implementations for titles in the allowlist
+        bool validateHostLibcRoutines; //!< If routines should be replaced for all titles with every call validated against the guest routines, this overrides the allowlist and only applies if hostLibcRoutines is enabled
 
         /**
          * @param fd An FD to the preference XML file
@@ -76,7 +76,16 @@ namespace skyline::signal {
         }
     }
 
+    static std::atomic<FaultHandler> ExceptionalFaultHandler{};
+
+    void SetFaultHandler(FaultHandler function) {
+        ExceptionalFaultHandler = function;
+    }
+
     void ExceptionalSignalHandler(int signal, siginfo *info, ucontext *context) {
+        if (auto faultHandler{ExceptionalFaultHandler.load()}; faultHandler && faultHandler(signal, info, context))
+            return;
+
         SignalException signalException;
         signalException.signal = signal;
         signalException.pc = reinterpret_cast<void *>(context->uc_mcontext.pc);
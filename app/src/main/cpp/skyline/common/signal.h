@@ -75,6 +75,14 @@ namespace skyline::signal {
      */
     void SetTlsRestorer(void *(*function)());
 
+    using FaultHandler = bool (*)(int, struct siginfo *, ucontext *);
+
+    /**
+     * @brief Sets a function which is given the first chance at handling any signal delivered to ExceptionalSignalHandler, the faulting instruction is retried if it returns true rather than an exception being thrown
+     * @note The function must be async-signal-safe as it can interrupt any host code
+     */
+    void SetFaultHandler(FaultHandler function);
+
     using SignalHandler = void (*)(int, struct siginfo *, ucontext *, void **);
 
     /**
@@ -22,5 +22,6 @@ namespace skyline::trace {
      */
     enum class TrackIds : u64 {
         Presentation = std::numeric_limits<u64>::max(),
+        SchedulerCores = Presentation - 4, //!< The first of 4 consecutive tracks for scheduling events on each core
     };
 }
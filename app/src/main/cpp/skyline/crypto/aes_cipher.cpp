@@ -1,6 +1,11 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <sys/auxv.h>
+#ifdef __ARM_FEATURE_CRYPTO
+#include <asm/hwcap.h>
+#include <arm_neon.h>
+#endif
 #include "aes_cipher.h"
 
 namespace skyline::crypto {
@@ -11,6 +16,129 @@ namespace skyline::crypto {
 
         if (mbedtls_cipher_setkey(&decryptContext, key.data(), key.size() * 8, MBEDTLS_DECRYPT) != 0)
             throw exception("Failed to set key for decryption context");
+
+        if ((type == MBEDTLS_CIPHER_AES_128_CTR || type == MBEDTLS_CIPHER_AES_192_CTR || type == MBEDTLS_CIPHER_AES_256_CTR) && IsHardwareAesSupported()) {
+            ExpandKey(key);
+            hardwareCtr = true;
+        }
+    }
+
+    bool AesCipher::IsHardwareAesSupported() {
+        #ifdef __ARM_FEATURE_CRYPTO
+        static bool supported{[]() {
+            if (!(getauxval(AT_HWCAP) & HWCAP_AES))
+                return false;
+
+            // The first two blocks of the CTR-AES128 test vector from NIST SP 800-38A F.5.1, the counter wraps its lowest byte on the second block
+            std::array<u8, 0x10> key{0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+            std::array<u8, 0x10> iv{0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF};
+            std::array<u8, 0x20> data{
+                0x87, 0x4D, 0x61, 0x91, 0xB6, 0x20, 0xE3, 0x26, 0x1B, 0xEF, 0x68, 0x64, 0x99, 0x0D, 0xB6, 0xCE,
+                0x98, 0x06, 0xF6, 0x6B, 0x79, 0x70, 0xFD, 0xFF, 0x86, 0x17, 0x18, 0x7B, 0xB9, 0xFF, 0xFD, 0xFF,
+            };
+            constexpr std::array<u8, 0x20> expected{
+                0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+                0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C, 0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51,
+            };
+
+            AesCipher cipher(key, MBEDTLS_CIPHER_AES_128_ECB); // ECB doesn't enable the hardware path, which would recurse into this
+            cipher.ExpandKey(key);
+            cipher.counter = iv;
+            cipher.HardwareCtrDecrypt(data.data(), data.data(), data.size());
+            return data == expected;
+        }()};
+        return supported;
+        #else
+        return false;
+        #endif
+    }
+
+    void AesCipher::ExpandKey(span<u8> key) {
+        #ifdef __ARM_FEATURE_CRYPTO
+        constexpr std::array<u8, 10> RoundConstants{0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+
+        // SubWord is done with AESE on a zero key, ShiftRows has no effect as the word is duplicated across every column
+        auto subWord{[](u32 word) {
+            return vgetq_lane_u32(vreinterpretq_u32_u8(vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(word)), vdupq_n_u8(0))), 0);
+        }};
+
+        size_t keyWords{key.size() / sizeof(u32)};
+        rounds = static_cast<u8>(keyWords + 6);
+
+        std::array<u32, (MaxRounds + 1) * 4> words{};
+        std::memcpy(words.data(), key.data(), key.size());
+        for (size_t index{keyWords}; index < (rounds + 1U) * 4; index++) {
+            u32 word{words[index - 1]};
+            if (index % keyWords == 0)
+                word = subWord((word >> 8) | (word << 24)) ^ RoundConstants[(index / keyWords) - 1]; // RotWord is a rotation by a byte as words are little-endian
+            else if (keyWords > 6 && index % keyWords == 4)
+                word = subWord(word);
+            words[index] = words[index - keyWords] ^ word;
+        }
+
+        std::memcpy(roundKeys.data(), words.data(), (rounds + 1U) * 0x10);
+        #endif
+    }
+
+    void AesCipher::HardwareCtrDecrypt(u8 *destination, u8 *source, size_t size) {
+        #ifdef __ARM_FEATURE_CRYPTO
+        std::array<uint8x16_t, MaxRounds + 1> keys;
+        for (size_t round{}; round <= rounds; round++)
+            keys[round] = vld1q_u8(roundKeys[round].data());
+
+        u64 high, low;
+        std::memcpy(&high, counter.data(), sizeof(u64));
+        std::memcpy(&low, counter.data() + sizeof(u64), sizeof(u64));
+        high = util::SwapEndianness(high);
+        low = util::SwapEndianness(low);
+
+        auto nextCounter{[&]() {
+            std::array<u64, 2> block{util::SwapEndianness(high), util::SwapEndianness(low)};
+            if (!++low)
+                high++;
+            return vld1q_u8(reinterpret_cast<u8 *>(block.data()));
+        }};
+
+        constexpr size_t BlockSize{0x10};
+        constexpr size_t ParallelBlocks{4}; //!< The amount of blocks that are encrypted at once, AESE and AESMC have a latency of multiple cycles so independent blocks are interleaved
+
+        auto encrypt{[&](auto &blocks) {
+            for (size_t round{}; round < rounds - 1U; round++)
+                for (auto &block : blocks)
+                    block = vaesmcq_u8(vaeseq_u8(block, keys[round]));
+            for (auto &block : blocks)
+                block = veorq_u8(vaeseq_u8(block, keys[rounds - 1U]), keys[rounds]);
+        }};
+
+        size_t offset{};
+        for (; offset + (ParallelBlocks * BlockSize) <= size; offset += ParallelBlocks * BlockSize) {
+            std::array<uint8x16_t, ParallelBlocks> blocks{nextCounter(), nextCounter(), nextCounter(), nextCounter()};
+            encrypt(blocks);
+            for (size_t index{}; index < ParallelBlocks; index++) {
+                auto position{offset + (index * BlockSize)};
+                vst1q_u8(destination + position, veorq_u8(vld1q_u8(source + position), blocks[index]));
+            }
+        }
+
+        for (; offset < size; offset += BlockSize) {
+            std::array<uint8x16_t, 1> blocks{nextCounter()};
+            encrypt(blocks);
+            if (size - offset >= BlockSize) {
+                vst1q_u8(destination + offset, veorq_u8(vld1q_u8(source + offset), blocks[0]));
+            } else {
+                std::array<u8, BlockSize> keystream;
+                vst1q_u8(keystream.data(), blocks[0]);
+                for (size_t index{}; index < size - offset; index++)
+                    destination[offset + index] = source[offset + index] ^ keystream[index];
+            }
+        }
+
+        // The counter is written back so further calls continue from the next block, the remainder of a partial block is discarded as it is by mbedtls_cipher_reset
+        high = util::SwapEndianness(high);
+        low = util::SwapEndianness(low);
+        std::memcpy(counter.data(), &high, sizeof(u64));
+        std::memcpy(counter.data() + sizeof(u64), &low, sizeof(u64));
+        #endif
     }
 
     AesCipher::~AesCipher() {
@@ -18,11 +146,21 @@ namespace skyline::crypto {
     }
 
     void AesCipher::SetIV(const std::array<u8, 0x10> &iv) {
+        if (hardwareCtr) {
+            counter = iv;
+            return;
+        }
+
         if (mbedtls_cipher_set_iv(&decryptContext, iv.data(), iv.size()) != 0)
             throw exception("Failed to set IV for decryption context");
     }
 
     void AesCipher::Decrypt(u8 *destination, u8 *source, size_t size) {
+        if (hardwareCtr) {
+            HardwareCtrDecrypt(destination, source, size); // CTR doesn't require a separate buffer for in-place decryption as every byte only depends on the corresponding byte of the source
+            return;
+        }
+
         constexpr size_t maxBufferSize = 1024 * 1024; //!< Buffer shouldn't grow larger than 1 MiB
 
         std::optional<std::vector<u8>> buf{};
@@ -16,6 +16,27 @@ namespace skyline::crypto {
         mbedtls_cipher_context_t decryptContext;
         std::vector<u8> buffer; //!< A buffer used to avoid constant memory allocation
 
+        static constexpr size_t MaxRounds{14}; //!< The amount of rounds used by AES-256
+        bool hardwareCtr{}; //!< If CTR decryption is done with the ARMv8 Crypto Extensions rather than mbedtls
+        u8 rounds{}; //!< The amount of AES rounds for the key
+        std::array<std::array<u8, 0x10>, MaxRounds + 1> roundKeys{}; //!< The expanded encryption key, this is only populated when hardwareCtr is set
+        std::array<u8, 0x10> counter{}; //!< The big-endian counter for the next block, this is only used when hardwareCtr is set
+
+        /**
+         * @return If the host supports the ARMv8 Crypto Extensions and they produce the expected results for a known test vector
+         */
+        static bool IsHardwareAesSupported();
+
+        /**
+         * @brief Expands the supplied key into roundKeys using the ARMv8 Crypto Extensions
+         */
+        void ExpandKey(span<u8> key);
+
+        /**
+         * @brief Decrypts data in AES-CTR mode using the ARMv8 Crypto Extensions, multiple blocks are encrypted in parallel to hide the latency of the AES instructions
+         */
+        void HardwareCtrDecrypt(u8 *destination, u8 *source, size_t size);
+
         /**
          * @brief Calculates IV for XTS, basically just big to little endian conversion
          */
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <asm/sigcontext.h>
+#include "dirty_tracker.h"
+
+namespace skyline::kernel {
+    DirtyTracker::DirtyTracker() : table(new RangeTable()) {
+        instance = this;
+        signal::SetFaultHandler(&DirtyTracker::HandleFault);
+    }
+
+    DirtyTracker::~DirtyTracker() {
+        DirtyTracker *self{this};
+        instance.compare_exchange_strong(self, nullptr);
+        Synchronize();
+        delete table.load();
+    }
+
+    void DirtyTracker::Synchronize() {
+        // Any handler which is registered in the previous generation's count may have read the prior state, handlers registering after this see the new generation and the new state
+        auto &handlers{activeHandlers[generation.fetch_add(1) & 1]};
+        while (handlers.load())
+            std::this_thread::yield();
+    }
+
+    DirtyTracker::TrackedRange *DirtyTracker::Find(const RangeTable &ranges, u8 *ptr, size_t size) {
+        for (const auto &range : ranges)
+            if (range->ptr <= ptr && ptr + size <= range->ptr + range->size)
+                return range.get();
+        return nullptr;
+    }
+
+    void DirtyTracker::Publish(std::unique_ptr<RangeTable> ranges) {
+        std::unique_ptr<RangeTable> previous{table.exchange(ranges.release())};
+
+        // Any fault handler which started before the exchange may still be reading the previous table, it's only destroyed after they've all returned
+        Synchronize();
+    }
+
+    void DirtyTracker::Track(u8 *ptr, size_t size) {
+        if (!util::PageAligned(ptr) || !util::PageAligned(size) || !size)
+            throw exception("Tracked range isn't page-aligned: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
+
+        std::unique_lock lock(mutex);
+        for (const auto &range : *table.load())
+            if (ptr < range->ptr + range->size && range->ptr < ptr + size)
+                throw exception("Tracked range overlaps an existing one: 0x{:X} - 0x{:X} and 0x{:X} - 0x{:X}", ptr, ptr + size, range->ptr, range->ptr + range->size);
+
+        auto pageCount{size / PAGE_SIZE};
+        auto pages{std::make_unique<PageState[]>(pageCount)};
+        auto currentEpoch{epoch.load()};
+        for (size_t index{}; index < pageCount; index++)
+            pages[index].writeEpoch = currentEpoch;
+
+        auto ranges{std::make_unique<RangeTable>(*table.load())};
+        ranges->push_back(std::make_shared<TrackedRange>(TrackedRange{ptr, size, std::move(pages)}));
+        Publish(std::move(ranges));
+    }
+
+    void DirtyTracker::Untrack(u8 *ptr, size_t size) {
+        std::unique_lock lock(mutex);
+        auto ranges{std::make_unique<RangeTable>(*table.load())};
+        auto range{std::find_if(ranges->begin(), ranges->end(), [&](const std::shared_ptr<TrackedRange> &range) { return range->ptr == ptr && range->size == size; })};
+        if (range == ranges->end())
+            throw exception("Untracking a range which isn't tracked: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
+
+        if (mprotect(ptr, size, PROT_READ | PROT_WRITE | PROT_EXEC) < 0)
+            throw exception("An error occurred while unprotecting a tracked range: {}", strerror(errno));
+
+        ranges->erase(range);
+        Publish(std::move(ranges));
+    }
+
+    u64 DirtyTracker::Protect(u8 *ptr, size_t size) {
+        auto start{util::AlignDown(ptr, PAGE_SIZE)}, end{util::AlignUp(ptr + size, PAGE_SIZE)};
+
+        std::shared_lock lock(mutex);
+        auto range{Find(*table.load(), start, static_cast<size_t>(end - start))};
+        if (!range)
+            throw exception("Protecting a range which isn't tracked: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
+
+        // The epoch is advanced prior to protecting the pages so that any write which faults afterwards is recorded with an epoch at least as new as the returned one
+        auto protectEpoch{epoch.fetch_add(1) + 1};
+
+        bool protect{};
+        for (auto page{start}; page < end; page += PAGE_SIZE) {
+            auto &protection{range->pages[static_cast<size_t>(page - range->ptr) / PAGE_SIZE].protection};
+            auto current{protection.load()};
+            while (current != PageProtection::Protected) {
+                if (current == PageProtection::Unprotecting) {
+                    // A fault handler is in the middle of unprotecting the page, it needs to finish before the page can be protected again or its mprotect could be reordered after ours
+                    std::this_thread::yield();
+                    current = protection.load();
+                } else if (protection.compare_exchange_weak(current, PageProtection::Protected)) {
+                    protect = true;
+                    break;
+                }
+            }
+        }
+
+        if (protect && mprotect(start, static_cast<size_t>(end - start), PROT_READ | PROT_EXEC) < 0)
+            throw exception("An error occurred while write-protecting a tracked range: {}", strerror(errno));
+
+        return protectEpoch;
+    }
+
+    bool DirtyTracker::IsDirty(u8 *ptr, size_t size, u64 sinceEpoch) {
+        auto start{util::AlignDown(ptr, PAGE_SIZE)}, end{util::AlignUp(ptr + size, PAGE_SIZE)};
+
+        std::shared_lock lock(mutex);
+        auto range{Find(*table.load(), start, static_cast<size_t>(end - start))};
+        if (!range)
+            throw exception("Querying a range which isn't tracked: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
+
+        for (auto page{start}; page < end; page += PAGE_SIZE)
+            if (range->pages[static_cast<size_t>(page - range->ptr) / PAGE_SIZE].writeEpoch.load(std::memory_order_relaxed) >= sinceEpoch)
+                return true;
+        return false;
+    }
+
+    /**
+     * @return If the fault described by the supplied context was caused by a write, this is determined by the WnR bit of the ESR which the kernel supplies for data aborts
+     * @note Faults without an ESR record are conservatively assumed to be writes
+     */
+    static bool IsWriteFault(ucontext *context) {
+        constexpr u64 EsrWnR{1 << 6}; //!< The bit in the ISS of a data abort which is set if it was caused by a write
+        auto header{reinterpret_cast<_aarch64_ctx *>(context->uc_mcontext.__reserved)};
+        while (header->magic && header->size) {
+            if (header->magic == ESR_MAGIC)
+                return reinterpret_cast<esr_context *>(header)->esr & EsrWnR;
+            header = reinterpret_cast<_aarch64_ctx *>(reinterpret_cast<u8 *>(header) + header->size);
+        }
+        return true;
+    }
+
+    bool DirtyTracker::HandleFault(int signal, siginfo *, ucontext *context) {
+        if (signal != SIGSEGV)
+            return false;
+
+        // A handler is only registered once the generation is confirmed to be unchanged after incrementing its count, so Synchronize never misses a handler that can read the state it's replacing
+        std::atomic<u32> *handlers;
+        while (true) {
+            auto currentGeneration{generation.load()};
+            handlers = &activeHandlers[currentGeneration & 1];
+            handlers->fetch_add(1);
+            if (generation.load() == currentGeneration)
+                break;
+            handlers->fetch_sub(1);
+        }
+
+        bool handled{[context]() {
+            auto tracker{instance.load()};
+            if (!tracker)
+                return false;
+
+            auto address{reinterpret_cast<u8 *>(context->uc_mcontext.fault_address)};
+            auto range{Find(*tracker->table.load(), address, 1)};
+            if (!range || !IsWriteFault(context))
+                return false; // Protected pages are still readable, so any read fault is genuine
+
+            auto &page{range->pages[static_cast<size_t>(address - range->ptr) / PAGE_SIZE]};
+            auto protection{PageProtection::Protected};
+            if (page.protection.compare_exchange_strong(protection, PageProtection::Unprotecting)) {
+                page.writeEpoch.store(tracker->epoch.load());
+                mprotect(util::AlignDown(address, PAGE_SIZE), PAGE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC); // This cannot throw as it's called from a signal handler, a failure will cause the fault to repeat and be treated as genuine
+                page.protection.store(PageProtection::Unprotected);
+                return true;
+            }
+
+            if (protection == PageProtection::Unprotecting)
+                return true; // Another thread is unprotecting the page, the write will succeed once it's done
+
+            // The page was unprotected by another thread after this fault occurred or the fault is genuine (such as the page having been freed), the instruction is retried once to tell these apart
+            // A racing fault can only happen once per unprotection of a page on a thread, so faulting again at the same PC and address without the page being unprotected again means that it isn't writable
+            auto pc{context->uc_mcontext.pc};
+            auto writeEpoch{page.writeEpoch.load()};
+            if (lastFaultAddress == address && lastFaultPc == pc && lastFaultEpoch == writeEpoch) {
+                lastFaultAddress = nullptr;
+                return false;
+            }
+
+            lastFaultAddress = address;
+            lastFaultPc = pc;
+            lastFaultEpoch = writeEpoch;
+            return true;
+        }()};
+        handlers->fetch_sub(1);
+
+        return handled;
+    }
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+#include <common/signal.h>
+
+namespace skyline::kernel {
+    /**
+     * @brief DirtyTracker records writes to registered ranges of guest memory, pages are write-protected and the epoch at which a write faults on them is recorded
+     * @note Tracked ranges must be backed by memory which is mapped as RWX as faulted pages are restored to RWX, this is how all guest memory is mapped on the host
+     * @note A range must be untracked before it's freed, unmapped or has its protection changed by anything else, otherwise a write to it may unprotect a page which shouldn't be accessible
+     * @note The first write to a protected page faults regardless of if it's from guest or host code, this includes the host threads of the GPU which use signal::ExceptionalSignalHandler, host code should avoid writing to tracked ranges where possible
+     */
+    class DirtyTracker {
+      private:
+        enum class PageProtection : u8 {
+            Unprotected, //!< The page is writable and writes to it aren't tracked
+            Protected, //!< The page has been write-protected and the next write to it will fault
+            Unprotecting, //!< A fault handler is currently unprotecting the page after recording a write to it
+        };
+
+        struct PageState {
+            std::atomic<u64> writeEpoch; //!< The epoch during which the page was last written to, this also identifies every unprotection of the page as an epoch is only recorded once per protection
+            std::atomic<PageProtection> protection;
+        };
+
+        struct TrackedRange {
+            u8 *ptr;
+            size_t size;
+            std::unique_ptr<PageState[]> pages;
+        };
+
+        using RangeTable = std::vector<std::shared_ptr<TrackedRange>>;
+
+        std::shared_mutex mutex; //!< Synchronizes modifications of the tracked ranges with queries, this is never locked by the fault handler
+        std::atomic<RangeTable *> table; //!< An immutable snapshot of all tracked ranges, it's replaced as a whole on every modification so that the fault handler can read it without any locking
+        std::atomic<u64> epoch{1}; //!< The current epoch, this is incremented every time a range is protected
+
+        inline static std::atomic<DirtyTracker *> instance{}; //!< The tracker which faults are handled by as the signal handler has no other way to access it
+        inline static std::atomic<u32> generation{}; //!< Incremented whenever a range table or the instance is replaced, fault handlers register themselves in the handler count selected by its parity
+        inline static std::array<std::atomic<u32>, 2> activeHandlers{}; //!< The amount of fault handlers which are accessing a range table or the instance for each parity of the generation they registered in
+
+        static thread_local inline u8 *lastFaultAddress{}; //!< The address of the last fault on an unprotected page which was retried by this thread
+        static thread_local inline u64 lastFaultPc{}; //!< The PC of the last fault on an unprotected page which was retried by this thread
+        static thread_local inline u64 lastFaultEpoch{}; //!< The write epoch of the page during the last fault on an unprotected page which was retried by this thread
+
+        /**
+         * @return The tracked range in the supplied table which entirely contains the supplied range or nullptr if there isn't one
+         */
+        static TrackedRange *Find(const RangeTable &ranges, u8 *ptr, size_t size);
+
+        /**
+         * @brief Waits for all fault handlers which could have read the range table or the instance prior to this being called to return
+         * @note Handlers which start afterwards register in the other handler count, so this only waits for the handlers that are already running rather than for the handler count to reach zero
+         */
+        static void Synchronize();
+
+        /**
+         * @brief Replaces the range table with the supplied one and destroys the previous table once no fault handler can be accessing it
+         * @note The mutex must be locked exclusively when calling this
+         */
+        void Publish(std::unique_ptr<RangeTable> ranges);
+
+      public:
+        DirtyTracker();
+
+        ~DirtyTracker();
+
+        /**
+         * @brief Starts tracking writes to the supplied page-aligned range, all pages are considered dirty until they're protected
+         */
+        void Track(u8 *ptr, size_t size);
+
+        /**
+         * @brief Stops tracking a range that was previously supplied to Track, any write-protected pages are unprotected
+         */
+        void Untrack(u8 *ptr, size_t size);
+
+        /**
+         * @brief Write-protects all pages overlapping the supplied range so that any subsequent writes to them are recorded
+         * @return An epoch which can be supplied to IsDirty to determine if the range was written to after this call
+         * @note Any reads of the range for synchronization purposes should be done after this returns
+         */
+        u64 Protect(u8 *ptr, size_t size);
+
+        /**
+         * @return If any page overlapping the supplied range was written to after the call to Protect that returned the supplied epoch
+         */
+        bool IsDirty(u8 *ptr, size_t size, u64 sinceEpoch);
+
+        /**
+         * @brief Handles a write fault on a page protected by the tracker by recording the write and unprotecting the page
+         * @return If the fault was handled and the faulting instruction should be retried, any fault that wasn't caused by the tracker returns false
+         * @note This is async-signal-safe and is designed to be called from a signal handler, it doesn't lock or allocate
+         */
+        static bool HandleFault(int signal, siginfo *info, ucontext *context);
+    };
+}
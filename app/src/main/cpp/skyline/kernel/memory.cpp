@@ -1,6 +1,11 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <asm/unistd.h>
+#include <fcntl.h>
+#include <linux/falloc.h>
+#include <linux/memfd.h>
+#include <unistd.h>
 #include "memory.h"
 #include "types/KProcess.h"
 
@@ -10,6 +15,10 @@ namespace skyline::kernel {
     MemoryManager::~MemoryManager() {
         if (base.address && base.size)
             munmap(reinterpret_cast<void *>(base.address), base.size);
+        if (mirror)
+            munmap(mirror, base.size);
+        if (memoryFd != -1)
+            close(memoryFd);
     }
 
     constexpr size_t RegionAlignment{1ULL << 21}; //!< The minimum alignment of a HOS memory region
@@ -61,10 +70,21 @@ namespace skyline::kernel {
         if (!base.address)
             throw exception("Cannot find a suitable carveout for the guest address space");
 
-        auto result{mmap(reinterpret_cast<void *>(base.address), base.size, PROT_NONE, MAP_FIXED | MAP_ANONYMOUS | MAP_PRIVATE, -1, 0)};
+        // The arena is sparse, pages are only allocated when they're first accessed and are released by FreeMemory
+        memoryFd = static_cast<int>(syscall(__NR_memfd_create, "HOS-AS", MFD_CLOEXEC));
+        if (memoryFd < 0)
+            throw exception("Failed to create the guest memory arena: {}", strerror(errno));
+        if (ftruncate(memoryFd, static_cast<off_t>(base.size)) < 0)
+            throw exception("Failed to resize the guest memory arena: {}", strerror(errno));
+
+        auto result{mmap(reinterpret_cast<void *>(base.address), base.size, PROT_NONE, MAP_FIXED | MAP_SHARED, memoryFd, 0)};
         if (result == MAP_FAILED)
             throw exception("Failed to mmap guest address space: {}", strerror(errno));
 
+        mirror = reinterpret_cast<u8 *>(mmap(nullptr, base.size, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0));
+        if (mirror == MAP_FAILED)
+            throw exception("Failed to mmap the guest memory mirror: {}", strerror(errno));
+
         chunks = {
             ChunkDescriptor{
                 .ptr = reinterpret_cast<u8 *>(addressSpace.address),
@@ -135,6 +155,73 @@ namespace skyline::kernel {
             .address + heap.size, heap.size, stack.address, stack.address + stack.size, stack.size, tlsIo.address, tlsIo.address + tlsIo.size, tlsIo.size);
     }
 
+    span<u8> MemoryManager::CreateMirrors(const std::vector<span<u8>> &regions) {
+        size_t totalSize{};
+        for (const auto &region : regions) {
+            if (!util::PageAligned(region.data()) || !util::PageAligned(region.size()))
+                throw exception("Mirrored region isn't page-aligned: 0x{:X} - 0x{:X} (0x{:X})", region.data(), region.data() + region.size(), region.size());
+            if (!base.IsInside(region.data()) || !base.IsInside(region.data() + region.size()))
+                throw exception("Mirrored region isn't inside guest address space: 0x{:X} - 0x{:X}", region.data(), region.data() + region.size());
+            totalSize += region.size();
+        }
+
+        auto mirrors{reinterpret_cast<u8 *>(mmap(nullptr, totalSize, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0))};
+        if (mirrors == MAP_FAILED)
+            throw exception("Failed to reserve address space for mirrors: {}", strerror(errno));
+
+        size_t offset{};
+        for (const auto &region : regions) {
+            if (mmap(mirrors + offset, region.size(), PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED, memoryFd, static_cast<off_t>(region.data() - reinterpret_cast<u8 *>(base.address))) == MAP_FAILED) {
+                munmap(mirrors, totalSize);
+                throw exception("Failed to mirror region 0x{:X} - 0x{:X}: {}", region.data(), region.data() + region.size(), strerror(errno));
+            }
+            offset += region.size();
+        }
+
+        return span(mirrors, totalSize);
+    }
+
+    bool MemoryManager::FreeMemory(u8 *ptr, size_t size) {
+        {
+            // Any part of an alias outside the freed range remains aliased, only the overlapping part is removed
+            std::scoped_lock lock(aliasMutex);
+            auto end{ptr + size};
+            auto alias{aliases.upper_bound(ptr)};
+            if (alias != aliases.begin() && std::prev(alias)->first + std::prev(alias)->second > ptr)
+                alias = std::prev(alias);
+            while (alias != aliases.end() && alias->first < end) {
+                auto [aliasPtr, aliasSize]{*alias};
+                alias = aliases.erase(alias);
+                if (aliasPtr < ptr)
+                    aliases.emplace(aliasPtr, static_cast<size_t>(ptr - aliasPtr));
+                if (aliasPtr + aliasSize > end)
+                    alias = aliases.emplace(end, static_cast<size_t>(aliasPtr + aliasSize - end)).first;
+            }
+        }
+
+        auto offset{static_cast<off_t>(ptr - reinterpret_cast<u8 *>(base.address))};
+        if (mmap(ptr, size, PROT_NONE, MAP_FIXED | MAP_SHARED, memoryFd, offset) == MAP_FAILED)
+            return false;
+        return fallocate(memoryFd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, static_cast<off_t>(size)) == 0;
+    }
+
+    void MemoryManager::MapAlias(u8 *source, u8 *destination, size_t size) {
+        if (!util::PageAligned(source) || !util::PageAligned(destination) || !util::PageAligned(size))
+            throw exception("Aliasing pages that aren't page-aligned: 0x{:X} -> 0x{:X} (0x{:X})", source, destination, size);
+
+        // The destination is mapped over the pages of the source in the arena, FreeMemory maps the destination's own pages back over it
+        if (mmap(destination, size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_FIXED | MAP_SHARED, memoryFd, static_cast<off_t>(source - reinterpret_cast<u8 *>(base.address))) == MAP_FAILED)
+            throw exception("An error occurred while aliasing 0x{:X} - 0x{:X} at 0x{:X}: {}", source, source + size, destination, strerror(errno));
+
+        std::scoped_lock lock(aliasMutex);
+        aliases.insert_or_assign(destination, size);
+    }
+
+    std::map<u8 *, size_t> MemoryManager::GetAliases() {
+        std::scoped_lock lock(aliasMutex);
+        return aliases;
+    }
+
     void MemoryManager::InsertChunk(const ChunkDescriptor &chunk) {
         std::unique_lock lock(mutex);
 
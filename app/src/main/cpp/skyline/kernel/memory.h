@@ -4,6 +4,7 @@
 #pragma once
 
 #include <common.h>
+#include "dirty_tracker.h"
 
 namespace skyline {
     namespace memory {
@@ -215,6 +216,9 @@ namespace skyline {
           private:
             const DeviceState &state;
             std::vector<ChunkDescriptor> chunks;
+            int memoryFd{-1}; //!< The memfd arena backing the entirety of the guest address space at the same offsets, any memory not mapped from another file descriptor is allocated from it
+            std::mutex aliasMutex; //!< Synchronizes access to the aliases, this is separate from the VMM mutex as FreeMemory is called while it may be held
+            std::map<u8 *, size_t> aliases; //!< The size of every range mapped by MapAlias which hasn't been freed yet indexed by its address
 
           public:
             memory::Region addressSpace{}; //!< The entire address space
@@ -224,8 +228,10 @@ namespace skyline {
             memory::Region heap{};
             memory::Region stack{};
             memory::Region tlsIo{}; //!< TLS/IO
+            u8 *mirror{}; //!< A host-only mapping of the arena which is always readable and writable, it allows access to guest memory regardless of guest permissions or dirty tracking
 
             std::shared_mutex mutex; //!< Synchronizes any operations done on the VMM, it's locked in shared mode by readers and exclusive mode by writers
+            DirtyTracker dirtyTracker; //!< Tracks writes to ranges of guest memory for any caches that depend on their contents
 
             MemoryManager(const DeviceState &state);
 
@@ -242,6 +248,42 @@ namespace skyline {
 
             std::optional<ChunkDescriptor> Get(void *ptr);
 
+            /**
+             * @return A pointer to the supplied guest address inside the mirror
+             * @note Only memory allocated from the arena is visible through the mirror, shared memory mapped into the guest is backed by its own file descriptor
+             * @note A range aliased by MapAlias isn't visible at its own address in the mirror, its contents are only visible at the address of the source range
+             * @note Writes through the mirror aren't observed by the DirtyTracker, any caches of the written range need to be invalidated by the writer
+             */
+            u8 *GetMirror(void *ptr) {
+                return mirror + (reinterpret_cast<u8 *>(ptr) - reinterpret_cast<u8 *>(base.address));
+            }
+
+            /**
+             * @brief Creates a single contiguous host mapping of the arena pages backing all of the supplied guest ranges in order
+             * @return The host mapping, it needs to be unmapped with munmap by the caller
+             * @note The same limitations as GetMirror apply to the returned mapping
+             */
+            span<u8> CreateMirrors(const std::vector<span<u8>> &regions);
+
+            /**
+             * @brief Returns a range of guest memory to the arena, the pages backing it are released and it's left inaccessible
+             * @note This is also used to remove a mapping from another file descriptor or an alias from MapAlias which was placed over the arena
+             * @return If the memory was freed successfully, errno is set on failure
+             */
+            bool FreeMemory(u8 *ptr, size_t size);
+
+            /**
+             * @brief Maps the arena pages backing the source range at the destination without copying them, writes to either range are visible through the other
+             * @note The source must be allocated from the arena, the alias is removed by freeing the destination with FreeMemory which leaves the pages of the source intact
+             * @note This doesn't modify the state of either range
+             */
+            void MapAlias(u8 *source, u8 *destination, size_t size);
+
+            /**
+             * @return All ranges mapped by MapAlias which haven't been freed yet, their own pages in the arena are unused and they shouldn't be accessed through the mirror
+             */
+            std::map<u8 *, size_t> GetAliases();
+
             /**
              * @return The cumulative size of all heap (Physical Memory + Process Heap) memory mappings, the code region and the main thread stack in bytes
              */
@@ -4,13 +4,89 @@
 #include <unistd.h>
 #include <common/signal.h>
 #include <common/trace.h>
-#include "types/KThread.h"
+#include "types/KProcess.h"
 #include "scheduler.h"
 
 namespace skyline::kernel {
     Scheduler::CoreContext::CoreContext(u8 id, u8 preemptionPriority) : id(id), preemptionPriority(preemptionPriority) {}
 
-    Scheduler::Scheduler(const DeviceState &state) : state(state) {}
+    /**
+     * @return The Perfetto track for scheduling events on the supplied core, these can be used to analyze migrations, preemptions and scheduling latency
+     */
+    static perfetto::Track GetCoreTrack(u8 coreId) {
+        return perfetto::Track(static_cast<u64>(trace::TrackIds::SchedulerCores) + coreId, perfetto::ProcessTrack::Current());
+    }
+
+    Scheduler::Scheduler(const DeviceState &state) : state(state) {
+        for (auto &core : cores) {
+            auto track{GetCoreTrack(core.id)};
+            auto desc{track.Serialize()};
+            desc.set_name(fmt::format("Core {}", core.id));
+            perfetto::TrackEvent::SetTrackDescriptor(track, desc);
+
+            core.preemptionTimer = std::thread(&Scheduler::PreemptionTimerLoop, this, std::ref(core));
+        }
+    }
+
+    Scheduler::~Scheduler() {
+        for (auto &core : cores) {
+            {
+                std::lock_guard lock(core.preemptionMutex);
+                core.preemptionTimerExit = true;
+                core.preemptionOwner = nullptr;
+            }
+            core.preemptionCondition.notify_one();
+        }
+
+        for (auto &core : cores)
+            if (core.preemptionTimer.joinable())
+                core.preemptionTimer.join();
+    }
+
+    void Scheduler::PreemptionTimerLoop(CoreContext &core) {
+        pthread_setname_np(pthread_self(), fmt::format("Preemption-C{}", core.id).c_str());
+
+        std::unique_lock lock(core.preemptionMutex);
+        while (!core.preemptionTimerExit) {
+            if (!core.preemptionOwner) {
+                core.preemptionTimerIdle = true;
+                core.preemptionCondition.wait(lock);
+                core.preemptionTimerIdle = false;
+            } else if (std::chrono::steady_clock::now() < core.preemptionDeadline) {
+                // The owner or deadline may have changed while waiting, they're rechecked on every wakeup rather than waking the timer when they change
+                core.preemptionCondition.wait_until(lock, core.preemptionDeadline);
+            } else {
+                // The signal is sent while holding the preemption mutex so it cannot be delivered after the owner has disarmed the timer
+                auto owner{std::move(core.preemptionOwner)};
+                core.preemptionOwner = nullptr;
+                TRACE_EVENT_INSTANT("scheduler", "Preempt", GetCoreTrack(core.id), "thread", owner->id);
+                owner->SendSignal(PreemptionSignal);
+            }
+        }
+    }
+
+    void Scheduler::ArmPreemptionTimer(CoreContext &core, const std::shared_ptr<type::KThread> &thread) {
+        std::lock_guard lock(core.preemptionMutex);
+        if (core.preemptionOwner == thread)
+            return;
+
+        core.preemptionOwner = thread;
+        core.preemptionDeadline = std::chrono::steady_clock::now() + PreemptiveTimeslice;
+        thread->isPreempted = true;
+
+        if (core.preemptionTimerIdle)
+            core.preemptionCondition.notify_one();
+    }
+
+    void Scheduler::DisarmPreemptionTimer(CoreContext &core, const std::shared_ptr<type::KThread> &thread) {
+        if (!thread->isPreempted) [[unlikely]]
+            return;
+
+        std::lock_guard lock(core.preemptionMutex);
+        if (core.preemptionOwner == thread)
+            core.preemptionOwner = nullptr;
+        thread->isPreempted = false;
+    }
 
     void Scheduler::SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls) {
         if (*tls) {
@@ -20,7 +96,9 @@ namespace skyline::kernel {
                 state.thread->isPreempted = false;
             state.scheduler->Rotate(false);
             YieldPending = false;
+            auto previousContext{std::exchange(state.thread->signalContext, ctx)}; // The guest context is only in the signal frame while waiting, it's exposed so it can be captured while the scheduler is paused
             state.scheduler->WaitSchedule();
+            state.thread->signalContext = previousContext;
             TRACE_EVENT_BEGIN("guest", "Guest");
         } else {
             YieldPending = true;
@@ -82,6 +160,18 @@ namespace skyline::kernel {
         return *currentCore;
     }
 
+    void Scheduler::MarkScheduled(const std::shared_ptr<type::KThread> &thread) {
+        if (!thread->isScheduled.exchange(true))
+            scheduledThreads++;
+    }
+
+    void Scheduler::MarkUnscheduled(const std::shared_ptr<type::KThread> &thread) {
+        if (thread->isScheduled.exchange(false) && scheduledThreads.fetch_sub(1) == 1 && paused) {
+            std::lock_guard lock(pauseMutex);
+            pauseCondition.notify_all();
+        }
+    }
+
     void Scheduler::InsertThread(const std::shared_ptr<type::KThread> &thread) {
         auto &core{cores.at(thread->coreId)};
         std::unique_lock lock(core.mutex);
@@ -131,6 +221,8 @@ namespace skyline::kernel {
         }
         lock.unlock();
 
+        TRACE_EVENT_INSTANT("scheduler", "Migrate", GetCoreTrack(targetCore->id), "thread", thread->id, "from", currentCore->id);
+
         thread->coreId = targetCore->id;
         if (wasInserted)
             // We need to add the thread to the ideal core queue, if it was previously its resident core's queue
@@ -143,6 +235,7 @@ namespace skyline::kernel {
     void Scheduler::WaitSchedule(bool loadBalance) {
         auto &thread{state.thread};
         CoreContext *core{&cores.at(thread->coreId)};
+        MarkUnscheduled(thread);
         std::unique_lock lock(core->mutex);
 
         auto wakeFunction{[&]() {
@@ -153,13 +246,17 @@ namespace skyline::kernel {
                 if (!thread->affinityMask.test(thread->coreId)) // We need to retest in case the thread was migrated while the core was unlocked
                     MigrateToCore(thread, core, &cores.at(thread->idealCore), lock);
             }
-            return !core->queue.empty() && core->queue.front() == thread;
+            return !paused && !core->queue.empty() && core->queue.front() == thread;
         }};
 
         TRACE_EVENT("scheduler", "WaitSchedule");
+        u64 waitStart{TRACE_EVENT_CATEGORY_ENABLED("scheduler") ? util::GetTimeNs() : 0}; // The wait is only timed when it'll be traced as reading the time isn't free
         if (loadBalance && thread->affinityMask.count() > 1) {
             std::chrono::milliseconds loadBalanceThreshold{PreemptiveTimeslice * 2}; //!< The amount of time that needs to pass unscheduled for a thread to attempt load balancing
             while (!thread->scheduleCondition.wait_for(lock, loadBalanceThreshold, wakeFunction)) {
+                if (paused)
+                    continue; // Threads shouldn't be migrated while the scheduler is paused, they're only waiting due to the pause
+
                 lock.unlock(); // We cannot call GetOptimalCoreForThread without relinquishing the core mutex
                 std::lock_guard migrationLock(thread->coreMigrationMutex);
                 auto newCore{&GetOptimalCoreForThread(state.thread)};
@@ -173,9 +270,14 @@ namespace skyline::kernel {
             thread->scheduleCondition.wait(lock, wakeFunction);
         }
 
+        MarkScheduled(thread);
+
+        if (waitStart)
+            TRACE_EVENT_INSTANT("scheduler", "Schedule", GetCoreTrack(core->id), "thread", thread->id, "priority", thread->priority.load(), "waitNs", util::GetTimeNs() - waitStart);
+
         if (thread->priority == core->preemptionPriority)
-            // If the thread needs to be preempted then arm its preemption timer
-            thread->ArmPreemptionTimer(PreemptiveTimeslice);
+            // If the thread needs to be preempted then arm the core's preemption timer for it
+            ArmPreemptionTimer(*core, thread);
 
         thread->timesliceStart = util::GetTimeTicks();
     }
@@ -185,16 +287,32 @@ namespace skyline::kernel {
         auto *core{&cores.at(thread->coreId)};
 
         TRACE_EVENT("scheduler", "TimedWaitSchedule");
+        u64 waitStart{TRACE_EVENT_CATEGORY_ENABLED("scheduler") ? util::GetTimeNs() : 0};
+        MarkUnscheduled(thread);
         std::unique_lock lock(core->mutex);
-        if (thread->scheduleCondition.wait_for(lock, timeout, [&]() {
+        auto isFront{[&]() {
             if (!thread->affinityMask.test(thread->coreId)) [[unlikely]] {
                 std::lock_guard migrationLock(thread->coreMigrationMutex);
                 MigrateToCore(thread, core, &cores.at(thread->idealCore), lock);
             }
             return !core->queue.empty() && core->queue.front() == thread;
-        })) {
+        }};
+
+        bool scheduled{thread->scheduleCondition.wait_for(lock, timeout, [&]() { return !paused && isFront(); })};
+        if (!scheduled && paused && isFront()) {
+            // The thread would've been scheduled before the timeout if the scheduler wasn't paused, it cannot time out as it may have already been woken up
+            thread->scheduleCondition.wait(lock, [&]() { return !paused && isFront(); });
+            scheduled = true;
+        }
+
+        if (scheduled) {
+            MarkScheduled(thread);
+
+            if (waitStart)
+                TRACE_EVENT_INSTANT("scheduler", "Schedule", GetCoreTrack(core->id), "thread", thread->id, "priority", thread->priority.load(), "waitNs", util::GetTimeNs() - waitStart);
+
             if (thread->priority == core->preemptionPriority)
-                thread->ArmPreemptionTimer(PreemptiveTimeslice);
+                ArmPreemptionTimer(*core, thread);
 
             thread->timesliceStart = util::GetTimeTicks();
 
@@ -225,9 +343,10 @@ namespace skyline::kernel {
 
         thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
 
-        thread->DisarmPreemptionTimer(); // If a preemptive thread did a cooperative yield then we need to disarm the preemptive timer
+        DisarmPreemptionTimer(core, thread); // If a preemptive thread did a cooperative yield then we need to disarm the preemptive timer
         thread->pendingYield = false;
         thread->forceYield = false;
+        MarkUnscheduled(thread);
     }
 
     void Scheduler::RemoveThread() {
@@ -249,10 +368,11 @@ namespace skyline::kernel {
             }
         }
 
-        thread->DisarmPreemptionTimer();
+        DisarmPreemptionTimer(core, thread);
         thread->pendingYield = false;
         thread->forceYield = false;
         YieldPending = false;
+        MarkUnscheduled(thread);
     }
 
     void Scheduler::UpdatePriority(const std::shared_ptr<type::KThread> &thread) {
@@ -271,11 +391,11 @@ namespace skyline::kernel {
                     thread->pendingYield = true;
                 }
             } else if (!thread->isPreempted && thread->priority == core->preemptionPriority) {
-                // If the thread needs to be preempted due to its new priority then arm its preemption timer
-                thread->ArmPreemptionTimer(PreemptiveTimeslice);
+                // If the thread needs to be preempted due to its new priority then arm the core's preemption timer for it
+                ArmPreemptionTimer(*core, thread);
             } else if (thread->isPreempted && thread->priority != core->preemptionPriority) {
-                // If the thread no longer needs to be preempted due to its new priority then disarm its preemption timer
-                thread->DisarmPreemptionTimer();
+                // If the thread no longer needs to be preempted due to its new priority then disarm the core's preemption timer
+                DisarmPreemptionTimer(*core, thread);
             }
         } else if (thread->priority < (*std::prev(currentIt))->priority || (nextIt != core->queue.end() && thread->priority > (*nextIt)->priority)) {
             // If the thread is in the queue and it's position is affected by the priority change then need to remove and re-insert the thread
@@ -343,4 +463,43 @@ namespace skyline::kernel {
             }
         }
     }
+
+    void Scheduler::Pause(std::chrono::milliseconds timeout) {
+        if (paused.exchange(true))
+            throw exception("The scheduler is already paused");
+
+        // A thread which was woken prior to the pause marks itself as scheduled before releasing its core's mutex, locking every core ensures that all of them are visible below
+        for (auto &core : cores) {
+            std::lock_guard lock(core.mutex);
+        }
+
+        {
+            std::lock_guard lock(state.process->threadMutex);
+            for (const auto &thread : state.process->threads) {
+                if (thread && thread->isScheduled) {
+                    std::lock_guard coreLock(cores.at(thread->coreId).mutex);
+                    if (!thread->pendingYield) {
+                        thread->SendSignal(YieldSignal);
+                        thread->pendingYield = true;
+                    }
+                }
+            }
+        }
+
+        std::unique_lock lock(pauseMutex);
+        if (!pauseCondition.wait_for(lock, timeout, [&]() { return !scheduledThreads; })) {
+            lock.unlock();
+            Resume();
+            throw exception("Timed out waiting for {} threads to yield while pausing the scheduler", scheduledThreads.load());
+        }
+    }
+
+    void Scheduler::Resume() {
+        paused = false;
+        for (auto &core : cores) {
+            std::lock_guard lock(core.mutex);
+            if (!core.queue.empty())
+                core.queue.front()->scheduleCondition.notify_one();
+        }
+    }
 }
@@ -5,6 +5,7 @@
 
 #include <common.h>
 #include <condition_variable>
+#include <thread>
 
 namespace skyline {
     namespace constant {
@@ -49,6 +50,14 @@ namespace skyline {
                 std::mutex mutex; //!< Synchronizes all operations on the queue
                 std::list<std::shared_ptr<type::KThread>> queue; //!< A queue of threads which are running or to be run on this core
 
+                std::thread preemptionTimer; //!< A host thread which acts as the preemption timer for all threads running on this core
+                std::mutex preemptionMutex; //!< Synchronizes all operations on the preemption state
+                std::condition_variable preemptionCondition; //!< Signalled to wake the preemption timer when it's armed while idle or when the scheduler is being destroyed
+                std::shared_ptr<type::KThread> preemptionOwner; //!< The preemptive thread running on this core which the timer is armed for, this is null if the timer isn't armed
+                std::chrono::steady_clock::time_point preemptionDeadline; //!< The time at which the owner should be preempted
+                bool preemptionTimerIdle{}; //!< If the preemption timer is waiting without a deadline, it needs to be woken up when armed
+                bool preemptionTimerExit{}; //!< If the preemption timer should exit
+
                 CoreContext(u8 id, u8 preemptionPriority);
             };
 
@@ -57,6 +66,21 @@ namespace skyline {
             std::mutex parkedMutex; //!< Synchronizes all operations on the queue of parked threads
             std::list<std::shared_ptr<type::KThread>> parkedQueue; //!< A queue of threads which are parked and waiting on core migration
 
+            std::atomic<bool> paused{}; //!< If no thread should be scheduled till Resume is called
+            std::atomic<u32> scheduledThreads{}; //!< The amount of threads which have been scheduled and haven't given up their core yet
+            std::mutex pauseMutex; //!< Synchronizes waiting on scheduledThreads to reach zero
+            std::condition_variable pauseCondition; //!< Signalled when the last scheduled thread gives up its core while paused
+
+            /**
+             * @brief Marks the calling thread as being scheduled on its resident core, this must be called with the core's mutex held
+             */
+            void MarkScheduled(const std::shared_ptr<type::KThread> &thread);
+
+            /**
+             * @brief Marks the calling thread as having given up its resident core, this is a no-op if it wasn't scheduled
+             */
+            void MarkUnscheduled(const std::shared_ptr<type::KThread> &thread);
+
             /**
              * @brief Migrate a thread from its resident core to its ideal core
              * @note 'KThread::coreMigrationMutex' **must** be locked by the calling thread prior to calling this
@@ -64,6 +88,23 @@ namespace skyline {
              */
             void MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<std::mutex> &lock);
 
+            /**
+             * @brief The loop of a core's preemption timer, it sends PreemptionSignal to the owner of the core once its timeslice has expired
+             */
+            void PreemptionTimerLoop(CoreContext &core);
+
+            /**
+             * @brief Arms the preemption timer of the supplied core for a preemptive thread which has been scheduled on it
+             * @note The timer is only re-armed when the owner changes, this avoids any syscalls in the common case where the timer thread is already sleeping
+             */
+            void ArmPreemptionTimer(CoreContext &core, const std::shared_ptr<type::KThread> &thread);
+
+            /**
+             * @brief Disarms the preemption timer of the supplied core if it's armed for the supplied thread
+             * @note This doesn't wake the timer thread, it'll notice that it has been disarmed when its current deadline expires
+             */
+            void DisarmPreemptionTimer(CoreContext &core, const std::shared_ptr<type::KThread> &thread);
+
           public:
             static constexpr std::chrono::milliseconds PreemptiveTimeslice{10}; //!< The duration of time a preemptive thread can run before yielding
             inline static int YieldSignal{SIGRTMIN}; //!< The signal used to cause a non-cooperative yield in running threads
@@ -72,6 +113,11 @@ namespace skyline {
 
             Scheduler(const DeviceState &state);
 
+            /**
+             * @brief Stops and joins the preemption timers of all cores
+             */
+            ~Scheduler();
+
             /**
              * @brief A signal handler designed to cause a non-cooperative yield for preemption and higher priority threads being inserted
              */
@@ -137,6 +183,18 @@ namespace skyline {
              * @note We will only wake a thread if it's determined to be a better pick than the thread which would be run on this core next
              */
             void WakeParkedThread();
+
+            /**
+             * @brief Yields all scheduled threads and prevents any thread from being scheduled till Resume is called, this returns once no thread is running guest code or an SVC
+             * @note This cannot be called from a guest thread, threads which are blocked inside an SVC stay blocked and aren't affected by this
+             * @note An exception is thrown if threads don't yield within the timeout, the scheduler is resumed prior to that
+             */
+            void Pause(std::chrono::milliseconds timeout = std::chrono::seconds(1));
+
+            /**
+             * @brief Allows threads to be scheduled again after a call to Pause
+             */
+            void Resume();
         };
 
         /**
@@ -158,5 +216,22 @@ namespace skyline {
                 state.scheduler->WaitSchedule();
             }
         };
+
+        /**
+         * @brief A lock which pauses the scheduler for its lifetime, see Scheduler::Pause
+         */
+        struct SchedulerPauseLock {
+          private:
+            const DeviceState &state;
+
+          public:
+            SchedulerPauseLock(const DeviceState &state) : state(state) {
+                state.scheduler->Pause();
+            }
+
+            ~SchedulerPauseLock() {
+                state.scheduler->Resume();
+            }
+        };
     }
 }
@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <random>
+#include <common/signal.h>
+#include "types/KThread.h"
+#include "scheduler_harness.h"
+
+namespace skyline::kernel {
+    SchedulerHarness::Workload SchedulerHarness::Generate(u64 seed, size_t threadCount, size_t operationCount) {
+        constexpr std::array<u8, 4> Priorities{28, 44, 44, 59}; //!< A mix of cooperative priorities and the preemptive priority of the application cores
+        constexpr u8 ApplicationCores{3}; //!< The amount of cores which are available to applications
+        constexpr CoreMask ApplicationCoreMask{0b111};
+
+        std::mt19937_64 generator(seed); // std::mt19937_64 produces the same sequence for a seed on every implementation, unlike the distributions
+        auto random{[&](u32 min, u32 max) {
+            return static_cast<u32>(min + (generator() % (max - min + 1)));
+        }};
+
+        Workload workload{.seed = seed};
+        for (size_t index{}; index < threadCount; index++) {
+            ThreadScript script{
+                .priority = Priorities[random(0, Priorities.size() - 1)],
+                .idealCore = static_cast<i8>(random(0, ApplicationCores - 1)),
+            };
+            script.affinityMask = random(0, 1) ? ApplicationCoreMask : CoreMask{}.set(script.idealCore);
+
+            script.operations.reserve(operationCount);
+            for (size_t operation{}; operation < operationCount; operation++) {
+                auto choice{random(0, 99)};
+                if (choice < 50)
+                    script.operations.push_back({Operation::Type::Run, random(50, 2000)});
+                else if (choice < 65)
+                    script.operations.push_back({Operation::Type::Yield});
+                else if (choice < 85)
+                    script.operations.push_back({Operation::Type::Sleep, random(100, 5000)});
+                else if (choice < 95)
+                    script.operations.push_back({Operation::Type::SetPriority, Priorities[random(0, Priorities.size() - 1)]});
+                else
+                    script.operations.push_back({Operation::Type::SetCore, random(0, ApplicationCores - 1)});
+            }
+
+            workload.threads.push_back(std::move(script));
+        }
+
+        return workload;
+    }
+
+    SchedulerHarness::Report SchedulerHarness::Run(const DeviceState &state, const Workload &workload) {
+        Report report{.seed = workload.seed};
+        report.threads.resize(workload.threads.size());
+
+        std::vector<std::shared_ptr<type::KThread>> threads;
+        for (size_t index{}; index < workload.threads.size(); index++) {
+            const auto &script{workload.threads[index]};
+            auto &thread{threads.emplace_back(std::make_shared<type::KThread>(state, 0, nullptr, index, nullptr, 0, nullptr, script.priority, script.idealCore))};
+            thread->affinityMask = script.affinityMask;
+            report.threads[index].priority = script.priority;
+        }
+
+        auto replay{[&state](const std::shared_ptr<type::KThread> &thread, const ThreadScript &script, ThreadReport &threadReport) {
+            signal::SetSignalHandler({Scheduler::YieldSignal, Scheduler::PreemptionSignal}, Scheduler::SignalHandler, false);
+            state.thread = thread;
+
+            {
+                std::lock_guard lock(thread->statusMutex);
+                thread->pthread = pthread_self();
+                thread->running = true;
+                thread->ready = true;
+                thread->statusCondition.notify_all();
+            }
+
+            i8 lastCore{-1};
+            auto waitSchedule{[&](bool loadBalance = true) {
+                auto waitStart{util::GetTimeNs()};
+                state.scheduler->WaitSchedule(loadBalance);
+                threadReport.waitTime += util::GetTimeNs() - waitStart;
+                threadReport.schedules++;
+                if (lastCore != -1 && lastCore != thread->coreId)
+                    threadReport.migrations++;
+                lastCore = thread->coreId;
+            }};
+
+            // This mirrors the handling of a pending yield after an SVC returns
+            auto handleYield{[&]() {
+                while (Scheduler::YieldPending) {
+                    state.scheduler->Rotate(false);
+                    Scheduler::YieldPending = false;
+                    waitSchedule();
+                }
+            }};
+
+            try {
+                {
+                    std::lock_guard lock(thread->coreMigrationMutex);
+                    thread->coreId = state.scheduler->GetOptimalCoreForThread(thread).id;
+                    state.scheduler->InsertThread(thread);
+                }
+                waitSchedule();
+
+                for (const auto &operation : script.operations) {
+                    switch (operation.type) {
+                        case Operation::Type::Run: {
+                            u64 remaining{static_cast<u64>(operation.value) * constant::NsInMicrosecond};
+                            while (remaining) {
+                                auto sliceStart{util::GetTimeNs()}, now{sliceStart};
+                                do {
+                                    std::atomic_signal_fence(std::memory_order_acquire); // YieldPending is written by the signal handler on this thread
+                                    now = util::GetTimeNs();
+                                } while (!Scheduler::YieldPending && now - sliceStart < remaining);
+
+                                auto ran{std::min(now - sliceStart, remaining)};
+                                remaining -= ran;
+                                threadReport.runTime += ran;
+                                handleYield();
+                            }
+                            break;
+                        }
+
+                        case Operation::Type::Yield:
+                            state.scheduler->Rotate();
+                            waitSchedule();
+                            break;
+
+                        case Operation::Type::Sleep: {
+                            state.scheduler->RemoveThread();
+                            std::this_thread::sleep_for(std::chrono::microseconds(operation.value));
+
+                            auto wakeTime{util::GetTimeNs()};
+                            state.scheduler->InsertThread(thread);
+                            waitSchedule();
+
+                            auto latency{util::GetTimeNs() - wakeTime};
+                            threadReport.wakeups++;
+                            threadReport.wakeupLatency += latency;
+                            threadReport.maxWakeupLatency = std::max(threadReport.maxWakeupLatency, latency);
+                            break;
+                        }
+
+                        case Operation::Type::SetPriority:
+                            thread->basePriority = static_cast<u8>(operation.value);
+                            thread->priority = static_cast<u8>(operation.value);
+                            state.scheduler->UpdatePriority(thread);
+                            break;
+
+                        case Operation::Type::SetCore: {
+                            auto idealCore{static_cast<i8>(operation.value)};
+                            std::unique_lock lock(thread->coreMigrationMutex);
+                            thread->idealCore = idealCore;
+                            if (!thread->affinityMask.test(idealCore))
+                                thread->affinityMask = CoreMask{}.set(idealCore);
+                            if (!thread->affinityMask.test(thread->coreId)) {
+                                state.scheduler->RemoveThread();
+                                thread->coreId = idealCore;
+                                state.scheduler->InsertThread(thread);
+                                lock.unlock(); // WaitSchedule locks the migration mutex itself when load balancing
+                                waitSchedule();
+                            }
+                            break;
+                        }
+                    }
+
+                    handleYield();
+                }
+            } catch (const std::exception &e) {
+                state.logger->Error("Scheduler harness thread T{} failed: {}", thread->id, e.what());
+            }
+
+            state.scheduler->RemoveThread();
+
+            {
+                std::lock_guard lock(thread->statusMutex);
+                thread->running = false;
+                thread->ready = false;
+                thread->statusCondition.notify_all();
+            }
+            state.thread = nullptr;
+        }};
+
+        auto startTime{util::GetTimeNs()};
+        {
+            std::vector<std::thread> hostThreads;
+            for (size_t index{}; index < threads.size(); index++)
+                hostThreads.emplace_back(replay, std::cref(threads[index]), std::cref(workload.threads[index]), std::ref(report.threads[index]));
+            for (auto &hostThread : hostThreads)
+                hostThread.join();
+        }
+        report.duration = util::GetTimeNs() - startTime;
+
+        for (const auto &script : workload.threads)
+            report.operations += script.operations.size();
+
+        return report;
+    }
+
+    void SchedulerHarness::Log(const DeviceState &state, const Report &report) {
+        u64 migrations{}, wakeups{}, wakeupLatency{}, maxWakeupLatency{};
+        for (const auto &thread : report.threads) {
+            migrations += thread.migrations;
+            wakeups += thread.wakeups;
+            wakeupLatency += thread.wakeupLatency;
+            maxWakeupLatency = std::max(maxWakeupLatency, thread.maxWakeupLatency);
+        }
+
+        state.logger->Info("Scheduler harness (Seed: 0x{:X}): {} threads ran {} operations in {}ms ({} operations/s), {} migrations, wakeup latency: {}us average, {}us max",
+                           report.seed, report.threads.size(), report.operations, report.duration / constant::NsInMillisecond, report.duration ? (report.operations * constant::NsInSecond) / report.duration : 0,
+                           migrations, wakeups ? (wakeupLatency / wakeups) / constant::NsInMicrosecond : 0, maxWakeupLatency / constant::NsInMicrosecond);
+
+        std::map<u8, std::vector<double>> shares; //!< The share of runnable time that each thread was running for, grouped by priority
+        for (const auto &thread : report.threads)
+            if (auto runnableTime{thread.runTime + thread.waitTime})
+                shares[thread.priority].push_back(static_cast<double>(thread.runTime) / static_cast<double>(runnableTime));
+
+        for (const auto &[priority, group] : shares) {
+            double sum{}, squareSum{};
+            for (auto share : group) {
+                sum += share;
+                squareSum += share * share;
+            }
+            state.logger->Info("Scheduler harness: Priority {}: {} threads, fairness {:.3f}", priority, group.size(), squareSum ? (sum * sum) / (static_cast<double>(group.size()) * squareSum) : 1.0);
+        }
+
+        for (size_t index{}; index < report.threads.size(); index++) {
+            const auto &thread{report.threads[index]};
+            state.logger->Debug("Scheduler harness: T{} (Priority {}): {}us running, {}us waiting, {} schedules, {} migrations, {} wakeups", index, thread.priority, thread.runTime / constant::NsInMicrosecond, thread.waitTime / constant::NsInMicrosecond, thread.schedules, thread.migrations, thread.wakeups);
+        }
+    }
+}
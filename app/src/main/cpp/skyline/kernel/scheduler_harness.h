@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "scheduler.h"
+
+namespace skyline::kernel {
+    /**
+     * @brief The SchedulerHarness drives the Scheduler with synthetic threads which replay a scripted workload generated from a seed, this allows scheduling changes to be evaluated without any guest code
+     * @note The synthetic threads run host code and interact with the Scheduler in the same way that SVCs do, so they're subject to the same yields and preemption as guest threads
+     * @note Only the workload is determined by the seed, the threads run on real host threads with wall-clock timing so the interleaving, the scheduling decisions and the reported metrics all vary between runs of the same seed
+     * @note As a result this doesn't replay deterministically and can't be used to regression-test individual scheduling decisions, it's only suitable for comparing aggregate metrics across several runs
+     * @note This is only run when building with the SCHEDULER_HARNESS CMake option as it delays launching the title by several seconds
+     */
+    class SchedulerHarness {
+      public:
+        static constexpr u64 DefaultSeed{0x5C4ED};
+
+        /**
+         * @brief A single step of a synthetic thread's script
+         */
+        struct Operation {
+            enum class Type : u8 {
+                Run, //!< Occupy the core for 'value' microseconds of CPU time, yielding whenever the scheduler requests it
+                Yield, //!< Cooperatively yield the core as svcSleepThread with a timeout of 0 would
+                Sleep, //!< Leave the scheduler for 'value' microseconds as svcSleepThread would
+                SetPriority, //!< Set the priority of the thread to 'value' as svcSetThreadPriority would
+                SetCore, //!< Set the ideal core of the thread to 'value' as svcSetThreadCoreMask would
+            } type;
+            u32 value;
+        };
+
+        struct ThreadScript {
+            u8 priority; //!< The initial priority of the thread
+            i8 idealCore; //!< The initial ideal core of the thread
+            CoreMask affinityMask; //!< The initial affinity mask of the thread
+            std::vector<Operation> operations;
+        };
+
+        struct Workload {
+            u64 seed; //!< The seed the workload was generated from
+            std::vector<ThreadScript> threads;
+        };
+
+        struct ThreadReport {
+            u8 priority; //!< The initial priority of the thread
+            u64 runTime{}; //!< The amount of time the thread spent running in nanoseconds
+            u64 waitTime{}; //!< The amount of time the thread spent runnable but waiting to be scheduled in nanoseconds
+            u64 schedules{}; //!< The amount of times the thread was scheduled
+            u64 migrations{}; //!< The amount of times the thread was scheduled on a different core than it was last scheduled on
+            u64 wakeups{}; //!< The amount of times the thread woke up from a sleep
+            u64 wakeupLatency{}; //!< The total time between waking up from a sleep and being scheduled in nanoseconds
+            u64 maxWakeupLatency{}; //!< The longest time between waking up from a sleep and being scheduled in nanoseconds
+        };
+
+        struct Report {
+            u64 seed;
+            u64 duration; //!< The wall-clock duration of the entire workload in nanoseconds
+            u64 operations; //!< The amount of operations executed by all threads
+            std::vector<ThreadReport> threads;
+        };
+
+        /**
+         * @brief Deterministically generates a workload of threads with a mix of priorities and affinities from the supplied seed
+         */
+        static Workload Generate(u64 seed, size_t threadCount = 8, size_t operationCount = 128);
+
+        /**
+         * @brief Replays the supplied workload on the Scheduler with a host thread for every synthetic thread
+         * @note This must not be called while any guest threads are running as they'd compete with the synthetic threads
+         */
+        static Report Run(const DeviceState &state, const Workload &workload);
+
+        /**
+         * @brief Logs the throughput, migrations and wakeup latency of the run alongside the fairness of every priority level
+         * @note Fairness is Jain's index over the share of runnable time each thread was scheduled for, 1.0 is perfectly fair and 1/N is the least fair for N threads
+         */
+        static void Log(const DeviceState &state, const Report &report);
+    };
+}
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <asm/sigcontext.h>
+#include <lz4.h>
+#include "types/KProcess.h"
+#include "snapshot.h"
+
+namespace skyline::kernel {
+    bool MemorySnapshot::IsCaptured(const ChunkDescriptor &chunk) {
+        auto state{chunk.state.value};
+        return state != memory::states::Unmapped.value && state != memory::states::Reserved.value && state != memory::states::SharedMemory.value && state != memory::states::TransferMemory.value && state != memory::states::TransferMemoryIsolated.value;
+    }
+
+    /**
+     * @return The first alias which ends after the supplied address
+     */
+    static std::map<u8 *, size_t>::const_iterator FindAlias(const std::map<u8 *, size_t> &aliases, u8 *ptr) {
+        auto alias{aliases.upper_bound(ptr)};
+        if (alias != aliases.begin() && std::prev(alias)->first + std::prev(alias)->second > ptr)
+            return std::prev(alias);
+        return alias;
+    }
+
+    MemorySnapshot::SaveStatistics MemorySnapshot::Save(MemoryManager &memory) {
+        SaveStatistics statistics{};
+        std::map<u8 *, Block> savedBlocks;
+        std::vector<u8> scratch(BlockSize);
+        chunks.clear();
+
+        // Aliases share the arena pages of their source which are captured alongside it, their own pages are unused and reading them through the mirror would needlessly allocate them
+        auto aliases{memory.GetAliases()};
+        auto end{reinterpret_cast<u8 *>(memory.base.address + memory.base.size)};
+        for (auto ptr{reinterpret_cast<u8 *>(memory.base.address)}; ptr < end;) {
+            auto chunk{memory.Get(ptr)};
+            if (!chunk)
+                break;
+            ptr = chunk->ptr + chunk->size;
+
+            if (!IsCaptured(*chunk))
+                continue;
+
+            auto chunkEnd{chunk->ptr + chunk->size}, rangePtr{chunk->ptr};
+            for (auto alias{FindAlias(aliases, rangePtr)}; rangePtr < chunkEnd; alias++) {
+                auto rangeEnd{(alias != aliases.end()) ? std::min(alias->first, chunkEnd) : chunkEnd};
+                if (rangePtr < rangeEnd) {
+                    auto &range{chunks.emplace_back(*chunk)};
+                    range.ptr = rangePtr;
+                    range.size = static_cast<size_t>(rangeEnd - rangePtr);
+                }
+                if (alias == aliases.end())
+                    break;
+                rangePtr = std::max(rangePtr, alias->first + alias->second);
+            }
+        }
+
+        for (const auto &chunk : chunks) {
+            auto chunkEnd{chunk.ptr + chunk.size};
+            for (auto blockPtr{chunk.ptr}; blockPtr < chunkEnd; blockPtr += BlockSize) {
+                auto blockSize{static_cast<u32>(std::min(BlockSize, static_cast<size_t>(chunkEnd - blockPtr)))};
+                auto contents{memory.GetMirror(blockPtr)}; // The mirror is always readable, the guest permissions of the chunk may change before it's restored
+                auto hash{std::hash<std::string_view>{}(std::string_view(reinterpret_cast<char *>(contents), blockSize))};
+                statistics.blockCount++;
+                statistics.uncompressedSize += blockSize;
+
+                auto existing{blocks.find(blockPtr)};
+                if (existing != blocks.end() && existing->second.hash == hash && existing->second.size == blockSize) {
+                    // A matching hash doesn't guarantee that the contents are unchanged, the prior contents are decompressed and compared to rule out a collision
+                    const auto &previous{existing->second};
+                    if (LZ4_decompress_safe(reinterpret_cast<const char *>(previous.data.data()), reinterpret_cast<char *>(scratch.data()), static_cast<int>(previous.data.size()), static_cast<int>(previous.size)) == static_cast<int>(previous.size) && std::memcmp(scratch.data(), contents, blockSize) == 0) {
+                        statistics.compressedSize += previous.data.size();
+                        savedBlocks.insert(blocks.extract(existing));
+                        continue;
+                    }
+                }
+
+                Block block{hash, blockSize};
+                block.data.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(blockSize))));
+                auto compressedSize{LZ4_compress_default(reinterpret_cast<char *>(contents), reinterpret_cast<char *>(block.data.data()), static_cast<int>(blockSize), static_cast<int>(block.data.size()))};
+                if (compressedSize <= 0)
+                    throw exception("Failed to compress guest memory at 0x{:X} (0x{:X} bytes)", blockPtr, blockSize);
+                block.data.resize(static_cast<size_t>(compressedSize));
+                block.data.shrink_to_fit();
+
+                statistics.compressedBlockCount++;
+                statistics.compressedSize += block.data.size();
+                savedBlocks.insert_or_assign(blockPtr, std::move(block));
+            }
+        }
+
+        blocks = std::move(savedBlocks);
+        return statistics;
+    }
+
+    void MemorySnapshot::Restore(MemoryManager &memory) {
+        auto aliases{memory.GetAliases()};
+        for (const auto &chunk : chunks) {
+            auto current{memory.Get(chunk.ptr)};
+            auto alias{FindAlias(aliases, chunk.ptr)};
+            if (!current || current->state.value != chunk.state.value || (current->ptr + current->size) < (chunk.ptr + chunk.size) || (alias != aliases.end() && alias->first < chunk.ptr + chunk.size))
+                throw exception("Guest memory layout has changed since the snapshot was saved: 0x{:X} - 0x{:X}", chunk.ptr, chunk.ptr + chunk.size);
+        }
+
+        for (const auto &[blockPtr, block] : blocks)
+            if (LZ4_decompress_safe(reinterpret_cast<const char *>(block.data.data()), reinterpret_cast<char *>(memory.GetMirror(blockPtr)), static_cast<int>(block.data.size()), static_cast<int>(block.size)) != static_cast<int>(block.size))
+                throw exception("Failed to decompress guest memory at 0x{:X} (0x{:X} bytes)", blockPtr, block.size);
+    }
+
+    /**
+     * @return The FP/SIMD record inside the supplied signal context, it's always present on AArch64
+     */
+    static fpsimd_context &GetFpsimdContext(ucontext *context) {
+        auto header{reinterpret_cast<_aarch64_ctx *>(context->uc_mcontext.__reserved)};
+        while (header->magic && header->size) {
+            if (header->magic == FPSIMD_MAGIC)
+                return *reinterpret_cast<fpsimd_context *>(header);
+            header = reinterpret_cast<_aarch64_ctx *>(reinterpret_cast<u8 *>(header) + header->size);
+        }
+        throw exception("Signal context doesn't contain an FP/SIMD record");
+    }
+
+    MemorySnapshot::SaveStatistics ProcessSnapshot::Save(const DeviceState &state) {
+        SchedulerPauseLock pauseLock(state);
+
+        std::vector<ThreadState> savedThreads;
+        {
+            std::lock_guard lock(state.process->threadMutex);
+            for (const auto &thread : state.process->threads) {
+                if (!thread || !thread->running)
+                    continue;
+
+                auto &saved{savedThreads.emplace_back(ThreadState{.id = thread->id, .tpidrEl0 = thread->ctx.tpidrEl0})};
+                if (auto context{thread->signalContext}) {
+                    saved.inGuest = true;
+                    auto &mctx{context->uc_mcontext};
+                    std::copy_n(mctx.regs, saved.regs.size(), saved.regs.begin());
+                    saved.sp = mctx.sp;
+                    saved.pc = mctx.pc;
+                    saved.pstate = mctx.pstate;
+
+                    auto &fpsimd{GetFpsimdContext(context)};
+                    std::copy_n(fpsimd.vregs, saved.vregs.size(), saved.vregs.begin());
+                    saved.fpsr = fpsimd.fpsr;
+                    saved.fpcr = fpsimd.fpcr;
+                } else {
+                    std::copy(thread->ctx.gpr.regs.begin(), thread->ctx.gpr.regs.end(), saved.regs.begin());
+                    saved.vregs = thread->ctx.fpr.regs;
+                }
+            }
+        }
+
+        auto statistics{memory.Save(state.process->memory)};
+        threads = std::move(savedThreads);
+        return statistics;
+    }
+
+    void ProcessSnapshot::Restore(const DeviceState &state) {
+        if (memory.Empty())
+            throw exception("Cannot restore a snapshot which hasn't been saved");
+
+        SchedulerPauseLock pauseLock(state);
+        std::lock_guard lock(state.process->threadMutex);
+
+        std::vector<std::pair<std::shared_ptr<type::KThread>, const ThreadState &>> targets;
+        for (const auto &saved : threads) {
+            auto thread{std::find_if(state.process->threads.begin(), state.process->threads.end(), [&](const std::shared_ptr<type::KThread> &thread) { return thread && thread->id == saved.id; })};
+            if (thread == state.process->threads.end() || !(*thread)->running)
+                throw exception("T{} has exited since the snapshot was saved", saved.id);
+            targets.emplace_back(*thread, saved);
+        }
+
+        for (const auto &thread : state.process->threads)
+            if (thread && thread->running && std::none_of(threads.begin(), threads.end(), [&](const ThreadState &saved) { return saved.id == thread->id; }))
+                throw exception("T{} was created after the snapshot was saved", thread->id);
+
+        memory.Restore(state.process->memory);
+
+        for (const auto &[thread, saved] : targets) {
+            constexpr size_t SvcRegisterCount{std::tuple_size_v<decltype(nce::GpRegisters::regs)>}; //!< The amount of registers which are captured for threads inside an SVC
+            thread->ctx.tpidrEl0 = saved.tpidrEl0;
+
+            if (auto context{thread->signalContext}) {
+                auto &mctx{context->uc_mcontext};
+                auto &fpsimd{GetFpsimdContext(context)};
+                std::copy(saved.vregs.begin(), saved.vregs.end(), fpsimd.vregs);
+                if (saved.inGuest) {
+                    std::copy(saved.regs.begin(), saved.regs.end(), mctx.regs);
+                    mctx.sp = saved.sp;
+                    mctx.pc = saved.pc;
+                    mctx.pstate = saved.pstate;
+                    fpsimd.fpsr = saved.fpsr;
+                    fpsimd.fpcr = saved.fpcr;
+                    continue;
+                }
+                std::copy_n(saved.regs.begin(), SvcRegisterCount, mctx.regs);
+            } else {
+                std::copy_n(saved.regs.begin(), SvcRegisterCount, thread->ctx.gpr.regs.begin());
+                thread->ctx.fpr.regs = saved.vregs;
+                if (!saved.inGuest)
+                    continue;
+            }
+
+            state.logger->Warn("T{} was paused {} when the snapshot was saved and {} now, only X0-X{} and the FP/SIMD registers were restored", thread->id, saved.inGuest ? "in guest code" : "inside an SVC", thread->signalContext ? "in guest code" : "inside an SVC", SvcRegisterCount - 1);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "memory.h"
+
+namespace skyline::kernel {
+    /**
+     * @brief A snapshot of the private guest memory of a process, it can be restored into the same process without reinitializing it
+     * @note Memory is captured in blocks which are compressed with LZ4, repeated saves only compress blocks with contents that changed since the prior save
+     * @note All memory allocated from the arena is captured through the mirror regardless of its current permissions, shared and transfer memory is owned by its kernel object and isn't captured
+     * @note Ranges aliased by svcMapMemory aren't captured as their contents are those of their source, which is captured
+     * @note The snapshot is only consistent if guest threads aren't running while it's saved or restored, the memory layout must also be the same while restoring as it was while saving
+     */
+    class MemorySnapshot {
+      private:
+        static constexpr size_t BlockSize{0x10000}; //!< The granularity at which memory is compared and compressed
+
+        struct Block {
+            size_t hash; //!< A hash of the uncompressed contents of the block, this is only used to skip comparisons of blocks that have certainly changed
+            u32 size; //!< The uncompressed size of the block
+            std::vector<u8> data; //!< The LZ4-compressed contents of the block
+        };
+        std::map<u8 *, Block> blocks; //!< All captured blocks indexed by their guest address
+        std::vector<ChunkDescriptor> chunks; //!< All parts of chunks that were captured, these exclude any aliases and are used to verify the memory layout prior to restoring
+
+        /**
+         * @return If the contents of the supplied chunk are backed by the arena and should be captured
+         */
+        static bool IsCaptured(const ChunkDescriptor &chunk);
+
+      public:
+        struct SaveStatistics {
+            size_t blockCount; //!< The total amount of blocks in the snapshot
+            size_t compressedBlockCount; //!< The amount of blocks which had changed and were compressed during the save
+            size_t uncompressedSize; //!< The total uncompressed size of all blocks in bytes
+            size_t compressedSize; //!< The total compressed size of all blocks in bytes
+        };
+
+        /**
+         * @brief Captures all private guest memory, blocks which haven't changed since the last save are reused as-is
+         * @note A block is only reused if its contents are identical to the decompressed contents of the prior save, a matching hash alone isn't sufficient
+         */
+        SaveStatistics Save(MemoryManager &memory);
+
+        /**
+         * @brief Writes the contents of the snapshot back into guest memory
+         * @note Writes are done through the mirror and aren't observed by the DirtyTracker
+         */
+        void Restore(MemoryManager &memory);
+
+        /**
+         * @return If the snapshot contains any memory
+         */
+        bool Empty() const {
+            return blocks.empty();
+        }
+    };
+
+    /**
+     * @brief A snapshot of the memory and the CPU state of all guest threads of a process, all guest threads are paused while it's saved or restored
+     * @note Threads are paused at the points where they yield to the scheduler, only X0-X18 and the FP/SIMD registers of threads paused inside an SVC can be captured as the remaining registers are held by the host
+     * @note Handle tables, kernel objects, service state and memory written by host threads (such as the GPU) aren't captured, restoring is only reliable if these haven't diverged since saving
+     */
+    class ProcessSnapshot {
+      private:
+        struct ThreadState {
+            size_t id;
+            bool inGuest; //!< If the thread was paused in guest code as opposed to inside an SVC, only the former has its entire context captured
+            std::array<u64, 31> regs; //!< X0-X30, only X0-X18 are valid if the thread wasn't paused in guest code
+            u64 sp;
+            u64 pc;
+            u64 pstate;
+            std::array<u128, 32> vregs;
+            u32 fpsr;
+            u32 fpcr;
+            u8 *tpidrEl0;
+        };
+
+        MemorySnapshot memory;
+        std::vector<ThreadState> threads;
+
+      public:
+        /**
+         * @brief Pauses the scheduler and captures the memory and all guest threads of the process
+         * @note This must not be called from a guest thread
+         */
+        MemorySnapshot::SaveStatistics Save(const DeviceState &state);
+
+        /**
+         * @brief Pauses the scheduler and restores the memory and all guest threads of the process to the state they were in when it was saved
+         * @note The process must have the same threads as it did while saving, an exception is thrown prior to any modification if it doesn't
+         */
+        void Restore(const DeviceState &state);
+    };
+}
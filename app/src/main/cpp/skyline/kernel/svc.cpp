@@ -114,7 +114,7 @@ namespace skyline::kernel::svc {
         }
 
         state.process->NewHandle<type::KPrivateMemory>(destination, size, chunk->permission, memory::states::Stack);
-        std::memcpy(destination, source, size);
+        state.process->memory.MapAlias(source, destination, size); // The destination shares the pages of the source, nothing is copied in either direction
 
         auto object{state.process->GetMemoryObject(source)};
         if (!object)
@@ -169,13 +169,11 @@ namespace skyline::kernel::svc {
 
         destObject->item->UpdatePermission(destination, size, sourceChunk->permission);
 
-        std::memcpy(source, destination, size);
-
         auto sourceObject{state.process->GetMemoryObject(source)};
         if (!sourceObject)
             throw exception("svcUnmapMemory: Cannot find source memory object in handle table for address 0x{:X}", source);
 
-        state.process->CloseHandle(sourceObject->handle);
+        state.process->CloseHandle(sourceObject->handle); // The alias is removed when its memory is freed, all writes to it were made to the pages of the destination
 
         state.logger->Debug("Unmapped range 0x{:X} - 0x{:X} to 0x{:X} - 0x{:X} (Size: 0x{:X} bytes)", source, source + size, destination, destination + size, size);
         state.ctx->gpr.w0 = Result{};
@@ -607,6 +605,7 @@ namespace skyline::kernel::svc {
 
     void WaitSynchronization(const DeviceState &state) {
         constexpr u8 maxSyncHandles{0x40}; // The total amount of handles that can be passed to WaitSynchronization
+        static_assert(std::tuple_size_v<decltype(type::KThread::syncWaiterNodes)> == maxSyncHandles);
 
         u32 numHandles{state.ctx->gpr.w2};
         if (numHandles > maxSyncHandles) {
@@ -672,9 +671,9 @@ namespace skyline::kernel::svc {
             return;
         }
 
-        auto priority{state.thread->priority.load()};
+        index = 0;
         for (const auto &object : objectTable)
-            object->syncObjectWaiters.insert(std::upper_bound(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), priority, type::KThread::IsHigherPriority), state.thread);
+            object->AddWaiter(state.thread->syncWaiterNodes[index++]);
 
         state.thread->isCancellable = true;
         state.thread->wakeObject = nullptr;
@@ -696,13 +695,7 @@ namespace skyline::kernel::svc {
             if (object.get() == wakeObject)
                 wakeIndex = index;
 
-            auto it{std::find(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), state.thread)};
-            if (it != object->syncObjectWaiters.end())
-                object->syncObjectWaiters.erase(it);
-            else
-                throw exception("svcWaitSynchronization: An object (0x{:X}) has been removed from the syncObjectWaiters queue incorrectly", waitHandles[index]);
-
-            index++;
+            object->RemoveWaiter(state.thread->syncWaiterNodes[index++]);
         }
 
         if (wakeObject) {
@@ -1068,7 +1061,7 @@ namespace skyline::kernel::svc {
                             item->Resize(0);
                             state.process->CloseHandle(memory->handle);
                         } else {
-                            item->Remap(pointer + size, item->size - (size + (item->ptr - pointer)));
+                            item->Remap(pointer + size, static_cast<size_t>((item->ptr + item->size) - (pointer + size)));
                         }
                     } else if (item->ptr < pointer) {
                         item->Resize(pointer - item->ptr);
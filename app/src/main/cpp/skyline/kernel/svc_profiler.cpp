@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "svc.h"
+#include "svc_profiler.h"
+
+namespace skyline::kernel {
+    static_assert(SvcProfiler::SvcCount == svc::SvcTable.size());
+
+    void SvcProfiler::Dump(const DeviceState &state) {
+        struct SvcStatistics {
+            u16 svcId;
+            u64 calls;
+            u64 totalDuration;
+            std::array<u64, BucketCount> histogram;
+        };
+        std::vector<SvcStatistics> svcs;
+
+        {
+            std::scoped_lock lock(mutex);
+            for (u16 svcId{}; svcId < SvcCount; svcId++) {
+                SvcStatistics svc{.svcId = svcId};
+                for (const auto &thread : threadStatistics) {
+                    for (size_t bucket{}; bucket < BucketCount; bucket++) {
+                        auto calls{thread->histograms[svcId][bucket].load(std::memory_order_relaxed)};
+                        svc.histogram[bucket] += calls;
+                        svc.calls += calls;
+                    }
+                    svc.totalDuration += thread->totalDurations[svcId].load(std::memory_order_relaxed);
+                }
+                if (svc.calls)
+                    svcs.push_back(svc);
+            }
+        }
+
+        std::sort(svcs.begin(), svcs.end(), [](const SvcStatistics &a, const SvcStatistics &b) {
+            return a.totalDuration > b.totalDuration;
+        });
+
+        for (const auto &svc : svcs) {
+            std::string histogram;
+            for (size_t bucket{}; bucket < BucketCount; bucket++)
+                if (svc.histogram[bucket])
+                    histogram += fmt::format(" [{}ns: {}]", 1ULL << bucket, svc.histogram[bucket]);
+
+            auto name{svc::SvcTable[svc.svcId].name};
+            state.logger->Info("SVC 0x{:02X} ({}): {} calls, {}us total, {}ns average, Histogram:{}", svc.svcId, name ? name : "Unimplemented", svc.calls, svc.totalDuration / constant::NsInMicrosecond, svc.totalDuration / svc.calls, histogram);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::kernel {
+    /**
+     * @brief SvcProfiler records the amount of calls to each SVC and a histogram of their latencies
+     * @note Every thread records into its own statistics without any synchronization beyond relaxed atomics, they're only aggregated when they're dumped
+     */
+    class SvcProfiler {
+      public:
+        static constexpr size_t SvcCount{0x80}; //!< The amount of SVCs which can be recorded, this must be the size of svc::SvcTable
+        static constexpr size_t BucketCount{40}; //!< The amount of buckets in a histogram, bucket N holds calls which took [2^N, 2^(N + 1)) nanoseconds
+
+      private:
+        struct ThreadStatistics {
+            std::array<std::array<std::atomic<u64>, BucketCount>, SvcCount> histograms{};
+            std::array<std::atomic<u64>, SvcCount> totalDurations{}; //!< The total duration of all calls to each SVC in nanoseconds
+        };
+
+        static inline std::mutex mutex; //!< Synchronizes access to threadStatistics
+        static inline std::vector<std::unique_ptr<ThreadStatistics>> threadStatistics; //!< The statistics of all threads which have recorded any calls, these are kept after a thread exits
+        static thread_local inline ThreadStatistics *statistics{}; //!< The statistics of the calling thread, they're allocated on the first call recorded by it
+
+      public:
+        static inline bool Enabled{}; //!< If SVCs should be profiled, this must be checked prior to calling Record
+
+        /**
+         * @brief Records a call to an SVC from the calling thread
+         */
+        static void Record(u16 svcId, u64 duration) {
+            if (!statistics) [[unlikely]] {
+                std::scoped_lock lock(mutex);
+                statistics = threadStatistics.emplace_back(std::make_unique<ThreadStatistics>()).get();
+            }
+
+            // This thread is the only writer, so a relaxed load and store is sufficient and avoids the cost of an atomic increment
+            auto &bucket{statistics->histograms[svcId][std::min<size_t>(std::bit_width(duration | 1) - 1, BucketCount - 1)]};
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            auto &total{statistics->totalDurations[svcId]};
+            total.store(total.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Aggregates the statistics of all threads and logs them for every SVC which was called, this can be done at any point
+         */
+        static void Dump(const DeviceState &state);
+    };
+}
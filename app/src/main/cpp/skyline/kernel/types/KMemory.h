@@ -27,7 +27,10 @@ namespace skyline::kernel::type {
          */
         virtual void UpdatePermission(u8 *ptr, size_t size, memory::Permission permission) = 0;
 
-        bool IsInside(u8 *ptr) {
+        /**
+         * @return If the supplied guest address is inside the memory object
+         */
+        virtual bool IsInside(u8 *ptr) {
             auto spn{Get()};
             return (spn.data() <= ptr) && ((spn.data() + spn.size()) > ptr);
         }
@@ -30,6 +30,9 @@ namespace skyline::kernel::type {
             throw exception("An occurred while resizing private memory: {}", strerror(errno));
 
         if (nSize < size) {
+            if (!state.process->memory.FreeMemory(ptr + nSize, size - nSize))
+                throw exception("An occurred while resizing private memory: {}", strerror(errno));
+
             state.process->memory.InsertChunk(ChunkDescriptor{
                 .ptr = ptr + nSize,
                 .size = size - nSize,
@@ -53,11 +56,35 @@ namespace skyline::kernel::type {
         if (!util::PageAligned(nPtr) || !util::PageAligned(nSize))
             throw exception("KPrivateMemory remapping isn't page-aligned: 0x{:X} - 0x{:X} (0x{:X})", nPtr, nPtr + nSize, nSize);
 
-        if (mprotect(ptr, size, PROT_NONE) < 0)
-            throw exception("An occurred while remapping private memory: {}", strerror(errno));
+        auto unmap{[&](u8 *unmapPtr, u8 *unmapEnd) {
+            if (!state.process->memory.FreeMemory(unmapPtr, static_cast<size_t>(unmapEnd - unmapPtr)))
+                throw exception("An occurred while remapping private memory: {}", strerror(errno));
+
+            state.process->memory.InsertChunk(ChunkDescriptor{
+                .ptr = unmapPtr,
+                .size = static_cast<size_t>(unmapEnd - unmapPtr),
+                .state = memory::states::Unmapped,
+            });
+        }};
+
+        auto end{ptr + size}, nEnd{nPtr + nSize};
+        if (ptr < nPtr)
+            unmap(ptr, std::min(end, nPtr));
+        if (end > nEnd)
+            unmap(std::max(ptr, nEnd), end);
 
-        if (mprotect(nPtr, nSize, PROT_NONE) < 0)
+        if (mprotect(nPtr, nSize, PROT_READ | PROT_WRITE | PROT_EXEC) < 0)
             throw exception("An occurred while remapping private memory: {}", strerror(errno));
+
+        state.process->memory.InsertChunk(ChunkDescriptor{
+            .ptr = nPtr,
+            .size = nSize,
+            .permission = permission,
+            .state = memoryState,
+        });
+
+        ptr = nPtr;
+        size = nSize;
     }
 
     void KPrivateMemory::UpdatePermission(u8 *pPtr, size_t pSize, memory::Permission pPermission) {
@@ -80,7 +107,7 @@ namespace skyline::kernel::type {
     }
 
     KPrivateMemory::~KPrivateMemory() {
-        mprotect(ptr, size, PROT_NONE);
+        state.process->memory.FreeMemory(ptr, size); // As this is the destructor, we cannot throw on this failing
         state.process->memory.InsertChunk(ChunkDescriptor{
             .ptr = ptr,
             .size = size,
@@ -30,6 +30,7 @@ namespace skyline::kernel::type {
         void Resize(size_t size);
 
         /**
+         * @brief Changes the range of the mapping, any parts of the previous range outside the new one are unmapped
          * @note This does not copy over anything, only contents of any overlapping regions will be retained
          */
         void Remap(u8 *ptr, size_t size);
@@ -5,6 +5,7 @@
 #include <os.h>
 #include <common/trace.h>
 #include <kernel/results.h>
+#include <kernel/svc_profiler.h>
 #include "KProcess.h"
 
 namespace skyline::kernel::type {
@@ -23,6 +24,9 @@ namespace skyline::kernel::type {
         disableThreadCreation = true;
         for (const auto &thread : threads)
             thread->Kill(true);
+
+        if (SvcProfiler::Enabled)
+            SvcProfiler::Dump(state);
     }
 
     void KProcess::Kill(bool join, bool all, bool disableCreation) {
@@ -106,6 +110,13 @@ namespace skyline::kernel::type {
     Result KProcess::MutexLock(u32 *mutex, KHandle ownerHandle, KHandle tag) {
         TRACE_EVENT_FMT("kernel", "MutexLock 0x{:X}", mutex);
 
+        // The mutex may have been released or handed off since the guest observed it, this can be resolved without looking up the owner or locking anything
+        u32 value{__atomic_load_n(mutex, __ATOMIC_SEQ_CST)};
+        if (!value && __atomic_compare_exchange_n(mutex, &value, tag, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            return {};
+        if (value != (ownerHandle | HandleWaitersBit))
+            return result::InvalidCurrentMemory;
+
         std::shared_ptr<KThread> owner;
         try {
             owner = GetHandle<KThread>(ownerHandle);
@@ -120,7 +131,7 @@ namespace skyline::kernel::type {
         {
             std::lock_guard lock(owner->waiterMutex);
 
-            u32 value{};
+            value = 0;
             if (__atomic_compare_exchange_n(mutex, &value, tag, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
                 // We try to do a CAS to get ownership of the mutex in the case that it's unoccupied
                 return {};
@@ -149,6 +160,11 @@ namespace skyline::kernel::type {
     void KProcess::MutexUnlock(u32 *mutex) {
         TRACE_EVENT_FMT("kernel", "MutexUnlock 0x{:X}", mutex);
 
+        // If the waiters bit isn't set then no thread can be waiting on the mutex as a waiter has to observe the bit while holding our waiter mutex, so it can be released without locking
+        u32 value{__atomic_load_n(mutex, __ATOMIC_SEQ_CST)};
+        if (!(value & HandleWaitersBit) && __atomic_compare_exchange_n(mutex, &value, 0, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            return;
+
         std::lock_guard lock(state.thread->waiterMutex);
         auto &waiters{state.thread->waiters};
         auto nextOwnerIt{std::find_if(waiters.begin(), waiters.end(), [mutex](const std::shared_ptr<KThread> &thread) { return thread->waitKey == mutex; })};
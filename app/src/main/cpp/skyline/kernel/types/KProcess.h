@@ -16,6 +16,10 @@ namespace skyline {
         constexpr KHandle BaseHandleIndex{0xD000}; //!< The index of the base handle
     }
 
+    namespace kernel {
+        class ProcessSnapshot;
+    }
+
     namespace kernel::type {
         /**
          * @brief KProcess manages process-global state such as memory, kernel handles allocated to the process and synchronization primitives
@@ -25,6 +29,9 @@ namespace skyline {
             MemoryManager memory;
 
           private:
+            friend Scheduler; //!< The scheduler yields every thread of the process when it's paused
+            friend ProcessSnapshot; //!< Snapshots capture and restore the context of every thread of the process
+
             std::mutex threadMutex; //!< Synchronizes thread creation to prevent a race between thread creation and thread killing
             bool disableThreadCreation{}; //!< Whether to disable thread creation, we use this to prevent thread creation after all threads have been killed
             std::vector<std::shared_ptr<KThread>> threads;
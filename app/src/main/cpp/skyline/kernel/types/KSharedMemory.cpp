@@ -20,45 +20,88 @@ namespace skyline::kernel::type {
         host.size = size;
     }
 
+    void KSharedMemory::RemoveGuestMappings(u8 *ptr, size_t size) {
+        auto end{ptr + size};
+        std::vector<MapInfo> remaining;
+        for (const auto &mapping : guest) {
+            auto mappingEnd{mapping.ptr + mapping.size};
+            if (mappingEnd <= ptr || mapping.ptr >= end) {
+                remaining.push_back(mapping);
+                continue;
+            }
+
+            if (mapping.ptr < ptr)
+                remaining.push_back(MapInfo{mapping.ptr, static_cast<size_t>(ptr - mapping.ptr), mapping.offset});
+            if (mappingEnd > end)
+                remaining.push_back(MapInfo{end, static_cast<size_t>(mappingEnd - end), mapping.offset + static_cast<size_t>(end - mapping.ptr)});
+        }
+        guest = std::move(remaining);
+    }
+
     u8 *KSharedMemory::Map(u8 *ptr, u64 size, memory::Permission permission) {
         if (!state.process->memory.base.IsInside(ptr) || !state.process->memory.base.IsInside(ptr + size))
-            throw exception("KPrivateMemory allocation isn't inside guest address space: 0x{:X} - 0x{:X}", ptr, ptr + size);
+            throw exception("KSharedMemory mapping isn't inside guest address space: 0x{:X} - 0x{:X}", ptr, ptr + size);
         if (!util::PageAligned(ptr) || !util::PageAligned(size))
             throw exception("KSharedMemory mapping isn't page-aligned: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
-        if (guest.Valid())
-            throw exception("Mapping KSharedMemory multiple times on guest is not supported: Requested Mapping: 0x{:X} - 0x{:X} (0x{:X}), Current Mapping: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size, guest.ptr, guest.ptr + guest.size, guest.size);
+        if (size > host.size)
+            throw exception("KSharedMemory mapping is larger than the shared memory: 0x{:X} - 0x{:X} (0x{:X}), Shared Memory Size: 0x{:X}", ptr, ptr + size, size, host.size);
 
-        guest.ptr = reinterpret_cast<u8 *>(mmap(ptr, size, permission.Get(), MAP_SHARED | (ptr ? MAP_FIXED : 0), fd, 0));
-        if (guest.ptr == MAP_FAILED)
+        std::scoped_lock lock(mappingMutex);
+
+        // Every guest mapping is a view of the same file descriptor, so additional mappings don't require any copies
+        auto mapping{reinterpret_cast<u8 *>(mmap(ptr, size, permission.Get(), MAP_SHARED | (ptr ? MAP_FIXED : 0), fd, 0))};
+        if (mapping == MAP_FAILED)
             throw exception("An error occurred while mapping shared memory in guest: {}", strerror(errno));
-        guest.size = size;
+
+        RemoveGuestMappings(mapping, size); // Any mappings in the range have been replaced by the new mapping
+        guest.push_back(MapInfo{mapping, size});
 
         state.process->memory.InsertChunk(ChunkDescriptor{
-            .ptr = guest.ptr,
+            .ptr = mapping,
             .size = size,
             .permission = permission,
             .state = memoryState,
         });
 
-        return guest.ptr;
+        return mapping;
     }
 
     void KSharedMemory::Unmap(u8 *ptr, u64 size) {
         if (!state.process->memory.base.IsInside(ptr) || !state.process->memory.base.IsInside(ptr + size))
-            throw exception("KPrivateMemory allocation isn't inside guest address space: 0x{:X} - 0x{:X}", ptr, ptr + size);
+            throw exception("KSharedMemory unmapping isn't inside guest address space: 0x{:X} - 0x{:X}", ptr, ptr + size);
         if (!util::PageAligned(ptr) || !util::PageAligned(size))
-            throw exception("KSharedMemory mapping isn't page-aligned: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
-        if (guest.ptr != ptr && guest.size != size)
-            throw exception("Unmapping KSharedMemory partially is not supported: Requested Unmap: 0x{:X} - 0x{:X} (0x{:X}), Current Mapping: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size, guest.ptr, guest.ptr + guest.size, guest.size);
+            throw exception("KSharedMemory unmapping isn't page-aligned: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
 
-        if (mmap(ptr, size, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED, 0, 0) == MAP_FAILED)
-            throw exception("An error occurred while unmapping shared memory in guest: {}", strerror(errno));
+        std::scoped_lock lock(mappingMutex);
 
-        guest = {};
-        state.process->memory.InsertChunk(ChunkDescriptor{
-            .ptr = ptr,
-            .size = size,
-            .state = memory::states::Unmapped,
+        auto end{ptr + size};
+        bool unmapped{};
+        for (const auto &mapping : guest) {
+            auto unmapStart{std::max(mapping.ptr, ptr)}, unmapEnd{std::min(mapping.ptr + mapping.size, end)};
+            if (unmapStart >= unmapEnd)
+                continue;
+
+            if (!state.process->memory.FreeMemory(unmapStart, static_cast<size_t>(unmapEnd - unmapStart)))
+                throw exception("An error occurred while unmapping shared memory in guest: {}", strerror(errno));
+
+            state.process->memory.InsertChunk(ChunkDescriptor{
+                .ptr = unmapStart,
+                .size = static_cast<size_t>(unmapEnd - unmapStart),
+                .state = memory::states::Unmapped,
+            });
+            unmapped = true;
+        }
+
+        if (!unmapped)
+            throw exception("Unmapping KSharedMemory which isn't mapped: 0x{:X} - 0x{:X} (0x{:X})", ptr, ptr + size, size);
+
+        RemoveGuestMappings(ptr, size);
+    }
+
+    bool KSharedMemory::IsInside(u8 *ptr) {
+        std::scoped_lock lock(mappingMutex);
+        return std::any_of(guest.begin(), guest.end(), [ptr](const MapInfo &mapping) {
+            return (mapping.ptr <= ptr) && ((mapping.ptr + mapping.size) > ptr);
         });
     }
 
@@ -66,9 +109,8 @@ namespace skyline::kernel::type {
         if (ptr && !util::PageAligned(ptr))
             throw exception("KSharedMemory permission updated with a non-page-aligned address: 0x{:X}", ptr);
 
-        if (guest.Valid()) {
-            mprotect(ptr, size, permission.Get());
-            if (guest.ptr == MAP_FAILED)
+        if (IsInside(ptr)) {
+            if (mprotect(ptr, size, permission.Get()) < 0)
                 throw exception("An error occurred while updating shared memory's permissions in guest: {}", strerror(errno));
 
             state.process->memory.InsertChunk(ChunkDescriptor{
@@ -84,13 +126,15 @@ namespace skyline::kernel::type {
         if (host.Valid())
             munmap(host.ptr, host.size);
 
-        if (state.process && guest.Valid()) {
-            mmap(guest.ptr, guest.size, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0); // As this is the destructor, we cannot throw on this failing
-            state.process->memory.InsertChunk(ChunkDescriptor{
-                .ptr = guest.ptr,
-                .size = guest.size,
-                .state = memory::states::Unmapped,
-            });
+        if (state.process) {
+            for (const auto &mapping : guest) {
+                state.process->memory.FreeMemory(mapping.ptr, mapping.size); // As this is the destructor, we cannot throw on this failing
+                state.process->memory.InsertChunk(ChunkDescriptor{
+                    .ptr = mapping.ptr,
+                    .size = mapping.size,
+                    .state = memory::states::Unmapped,
+                });
+            }
         }
 
         close(fd);
@@ -13,37 +13,54 @@ namespace skyline::kernel::type {
       private:
         int fd; //!< A file descriptor to the underlying shared memory
         memory::MemoryState memoryState; //!< The state of the memory as supplied initially, this is retained for any mappings
+        std::mutex mappingMutex; //!< Synchronizes all accesses to the guest mappings
+
+        /**
+         * @brief Removes the supplied range from the guest mappings, splitting any mappings which are partially inside it
+         * @note The mapping mutex must be locked when calling this
+         */
+        void RemoveGuestMappings(u8 *ptr, size_t size);
 
       public:
         struct MapInfo {
             u8 *ptr;
             size_t size;
+            size_t offset{}; //!< The offset of the mapping into the underlying shared memory
 
             constexpr bool Valid() {
                 return ptr && size;
             }
-        } host, guest{}; //!< We keep two mirrors of the underlying shared memory for guest access and host access, the host mirror is persistently mapped and should be used by anything accessing the memory on the host
+        } host; //!< The host mirror of the underlying shared memory, it is persistently mapped and should be used by anything accessing the memory on the host
+        std::vector<MapInfo> guest; //!< All guest mappings of the underlying shared memory, these are all views of the same memory as the host mirror and don't require any copies
 
         KSharedMemory(const DeviceState &state, size_t size, memory::MemoryState memState = memory::states::SharedMemory, KType type = KType::KSharedMemory);
 
         /**
+         * @brief Maps the shared memory on the guest, it can be mapped at multiple addresses simultaneously and any existing mappings of it in the range are replaced
          * @note 'ptr' needs to be in guest-reserved address space
          */
         u8 *Map(u8 *ptr, u64 size, memory::Permission permission);
 
         /**
+         * @brief Unmaps any guest mappings of the shared memory in the supplied range, this can be a part of a mapping or span multiple mappings
          * @note 'ptr' needs to be in guest-reserved address space
          */
         void Unmap(u8 *ptr, u64 size);
 
+        /**
+         * @return The first guest mapping of the shared memory or an empty span if it isn't mapped
+         */
         span<u8> Get() override {
-            return span(guest.ptr, guest.size);
+            std::scoped_lock lock(mappingMutex);
+            return guest.empty() ? span<u8>{} : span(guest.front().ptr, guest.front().size);
         }
 
+        bool IsInside(u8 *ptr) override;
+
         void UpdatePermission(u8 *ptr, size_t size, memory::Permission permission) override;
 
         /**
-         * @brief The destructor of shared memory, it deallocates the memory from all processes
+         * @brief The destructor of shared memory, it deallocates the memory from all processes and unmaps all guest mappings
          */
         ~KSharedMemory();
     };
@@ -8,11 +8,12 @@ namespace skyline::kernel::type {
     void KSyncObject::Signal() {
         std::lock_guard lock(syncObjectMutex);
         signalled = true;
-        for (auto &waiter : syncObjectWaiters) {
-            if (waiter->isCancellable) {
-                waiter->isCancellable = false;
-                waiter->wakeObject = this;
-                state.scheduler->InsertThread(waiter);
+        for (auto waiter{syncObjectWaiters}; waiter; waiter = waiter->next) {
+            auto thread{waiter->thread};
+            if (thread->isCancellable) {
+                thread->isCancellable = false;
+                thread->wakeObject = this;
+                state.scheduler->InsertThread(thread->shared_from_this());
             }
         }
     }
@@ -6,6 +6,15 @@
 #include "KObject.h"
 
 namespace skyline::kernel::type {
+    /**
+     * @brief A node in the intrusive list of threads waiting on a KSyncObject, these are embedded in KThread so waiting doesn't require any allocations
+     */
+    struct KSyncObjectWaiter {
+        KThread *thread; //!< The thread which this node belongs to
+        KSyncObjectWaiter *previous{}; //!< The previous waiter on the object or nullptr if this is the first one
+        KSyncObjectWaiter *next{}; //!< The next waiter on the object or nullptr if this is the last one
+    };
+
     /**
      * @brief KSyncObject is an abstract class which holds everything necessary for an object to be synchronizable
      * @note This abstraction is roughly equivalent to KSynchronizationObject on HOS
@@ -13,7 +22,7 @@ namespace skyline::kernel::type {
     class KSyncObject : public KObject {
       public:
         inline static std::mutex syncObjectMutex; //!< A global lock used for locking all signalling to avoid races
-        std::list<std::shared_ptr<KThread>> syncObjectWaiters; //!< A list of threads waiting on this object to be signalled
+        KSyncObjectWaiter *syncObjectWaiters{}; //!< An intrusive list of threads waiting on this object to be signalled, this is the first node in it
         bool signalled; //!< If the current object is signalled (An object stays signalled till the signal has been explicitly reset)
 
         /**
@@ -21,6 +30,32 @@ namespace skyline::kernel::type {
          */
         KSyncObject(const DeviceState &state, skyline::kernel::type::KType type, bool presignalled = false) : KObject(state, type), signalled(presignalled) {};
 
+        /**
+         * @brief Inserts the supplied node at the front of this object's waiter list
+         * @note 'syncObjectMutex' **must** be locked by the calling thread prior to calling this
+         */
+        void AddWaiter(KSyncObjectWaiter &waiter) {
+            waiter.previous = nullptr;
+            waiter.next = syncObjectWaiters;
+            if (syncObjectWaiters)
+                syncObjectWaiters->previous = &waiter;
+            syncObjectWaiters = &waiter;
+        }
+
+        /**
+         * @brief Removes the supplied node from this object's waiter list, it must have been inserted with AddWaiter prior
+         * @note 'syncObjectMutex' **must** be locked by the calling thread prior to calling this
+         */
+        void RemoveWaiter(KSyncObjectWaiter &waiter) {
+            if (waiter.previous)
+                waiter.previous->next = waiter.next;
+            else
+                syncObjectWaiters = waiter.next;
+            if (waiter.next)
+                waiter.next->previous = waiter.previous;
+            waiter.previous = waiter.next = nullptr;
+        }
+
         /**
          * @brief Wakes up any waiters on this object and flips the 'signalled' flag
          */
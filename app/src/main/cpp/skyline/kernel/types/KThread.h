@@ -12,16 +12,21 @@
 #include "KSharedMemory.h"
 
 namespace skyline {
+    namespace kernel {
+        class SchedulerHarness;
+    }
+
     namespace kernel::type {
         /**
          * @brief KThread manages a single thread of execution which is responsible for running guest code and kernel code which is invoked by the guest
          */
         class KThread : public KSyncObject, public std::enable_shared_from_this<KThread> {
           private:
+            friend SchedulerHarness; //!< The harness drives synthetic threads from host threads that it creates itself
+
             KProcess *parent;
             std::thread thread; //!< If this KThread is backed by a host thread then this'll hold it
             pthread_t pthread{}; //!< The pthread_t for the host thread running this guest thread
-            timer_t preemptionTimer{}; //!< A kernel timer used for preemption interrupts
 
             /**
              * @brief Entry function any guest threads, sets up necessary context and jumps into guest code from the calling thread
@@ -58,9 +63,11 @@ namespace skyline {
             u64 timesliceStart{}; //!< A timestamp in host CNTVCT ticks of when the thread's current timeslice started
             u64 averageTimeslice{}; //!< A weighted average of the timeslice duration for this thread
 
-            bool isPreempted{}; //!< If the preemption timer has been armed and will fire
+            bool isPreempted{}; //!< If the preemption timer of the thread's resident core has been armed for this thread and will fire
             bool pendingYield{}; //!< If the thread has been yielded and hasn't been acted upon it yet
             bool forceYield{}; //!< If the thread has been forcefully yielded by another thread
+            std::atomic<bool> isScheduled{}; //!< If the thread is scheduled on its resident core and hasn't given it up yet, this is only modified by the thread itself
+            ucontext *signalContext{}; //!< The context of the guest code which was interrupted by a yield signal while the thread waits to be rescheduled inside the signal handler
 
             std::mutex waiterMutex; //!< Synchronizes operations on mutation of the waiter members
             u32 *waitKey; //!< The key of the mutex which this thread is waiting on
@@ -71,6 +78,7 @@ namespace skyline {
             bool isCancellable{false}; //!< If the thread is currently in a position where it's cancellable
             bool cancelSync{false}; //!< Whether to cancel the SvcWaitSynchronization call this thread currently is in/the next one it joins
             type::KSyncObject *wakeObject{}; //!< A pointer to the synchronization object responsible for waking this thread up
+            std::array<KSyncObjectWaiter, 0x40> syncWaiterNodes{}; //!< The nodes used to wait on synchronization objects, one for every handle that can be supplied to svcWaitSynchronization
 
             KThread(const DeviceState &state, KHandle handle, KProcess *parent, size_t id, void *entry, u64 argument, void *stackTop, u8 priority, i8 idealCore);
 
@@ -93,16 +101,6 @@ namespace skyline {
              */
             void SendSignal(int signal);
 
-            /**
-             * @brief Arms the preemption kernel timer to fire in the specified amount of time
-             */
-            void ArmPreemptionTimer(std::chrono::nanoseconds timeToFire);
-
-            /**
-             * @brief Disarms the preemption kernel timer, any scheduled firings will be cancelled
-             */
-            void DisarmPreemptionTimer();
-
             /**
              * @brief Recursively updates the priority for any threads this thread might be waiting on
              * @note PI is performed by temporarily upgrading a thread's priority if a thread waiting on it has a higher priority to prevent priority inversion
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "KTransferMemory.h"
+#include "KProcess.h"
+
+namespace skyline::kernel::type {
+    KTransferMemory::KTransferMemory(const DeviceState &state, u8 *ptr, size_t size, memory::Permission permission, memory::MemoryState memState) : KSharedMemory(state, size, memState, KType::KTransferMemory) {
+        for (auto address{ptr}; address < ptr + size;) {
+            auto chunk{state.process->memory.Get(address)};
+            if (!chunk)
+                throw exception("KTransferMemory created from memory without a descriptor: 0x{:X} - 0x{:X}", ptr, ptr + size);
+
+            chunk->size = static_cast<size_t>(std::min(chunk->ptr + chunk->size, ptr + size) - address);
+            chunk->ptr = address;
+            address += chunk->size;
+            originalChunks.push_back(*chunk);
+        }
+
+        std::memcpy(host.ptr, ptr, size);
+        Map(ptr, size, permission);
+    }
+
+    KTransferMemory::~KTransferMemory() {
+        if (!state.process || originalChunks.empty())
+            return;
+
+        auto ptr{originalChunks.front().ptr};
+        auto size{static_cast<size_t>((originalChunks.back().ptr + originalChunks.back().size) - ptr)};
+
+        // The shared mapping is replaced with arena memory holding the current contents, this is done here as the KSharedMemory destructor would unmap it instead
+        if (!state.process->memory.FreeMemory(ptr, size) || mprotect(ptr, size, PROT_READ | PROT_WRITE | PROT_EXEC) < 0) {
+            state.logger->Error("An error occurred while restoring the memory of transfer memory: {}", strerror(errno)); // As this is the destructor, we cannot throw on this failing
+            return;
+        }
+
+        std::memcpy(ptr, host.ptr, size);
+        guest.clear();
+
+        for (const auto &chunk : originalChunks)
+            state.process->memory.InsertChunk(chunk);
+    }
+}
@@ -8,15 +8,21 @@
 namespace skyline::kernel::type {
     /**
      * @brief KTransferMemory is used to transfer memory from one application to another on HOS, we emulate this abstraction using KSharedMemory as it's essentially the same with the main difference being that KSharedMemory is allocated by the kernel while KTransferMemory is created from memory that's been allocated by the guest beforehand
+     * @note The guest memory is replaced by a shared mapping of the underlying memory for the lifetime of the object, services should access it through the host mirror which is stable and independent of the guest permissions
      */
     class KTransferMemory : public KSharedMemory {
+      private:
+        std::vector<ChunkDescriptor> originalChunks; //!< The chunks of guest memory which were replaced by the transfer memory, they're restored when it's closed
+
       public:
         /**
          * @note 'ptr' needs to be in guest-reserved address space
          */
-        KTransferMemory(const DeviceState &state, u8 *ptr, size_t size, memory::Permission permission, memory::MemoryState memState = memory::states::TransferMemory) : KSharedMemory(state, size, memState, KType::KTransferMemory) {
-            std::memcpy(host.ptr, ptr, size);
-            Map(ptr, size, permission);
-        }
+        KTransferMemory(const DeviceState &state, u8 *ptr, size_t size, memory::Permission permission, memory::MemoryState memState = memory::states::TransferMemory);
+
+        /**
+         * @brief Restores the guest memory that the transfer memory was created from with its current contents along with its original state and permissions
+         */
+        ~KTransferMemory();
     };
 }
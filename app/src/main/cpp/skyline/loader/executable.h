@@ -14,11 +14,20 @@ namespace skyline::loader {
          * @brief The contents and offset of an executable segment
          */
         struct Segment {
-            std::vector<u8> contents; //!< The raw contents of the segment
+            std::vector<u8> contents; //!< The raw contents of the segment, this is empty if the segment is written into guest memory by the load function
             size_t offset; //!< The offset from the base address to load the segment at
+            size_t size; //!< The size of the segment in memory, this is only used if the segment has a load function
+            std::function<void(span<u8>)> load; //!< A function that writes the contents of the segment directly into guest memory, this avoids an intermediate copy and can be run in parallel with other segments
+
+            /**
+             * @return The size of the segment in memory
+             */
+            size_t Size() const {
+                return load ? size : contents.size();
+            }
         };
 
-        Segment text; //!< The .text segment container
+        Segment text; //!< The .text segment container, it cannot have a load function as it needs to be scanned and patched prior to being written into guest memory
         Segment ro; //!< The .rodata segment container
         Segment data; //!< The .data segment container
         size_t bssSize; //!< The size of the .bss segment
@@ -30,5 +39,8 @@ namespace skyline::loader {
 
         RelativeSegment dynsym; //!< The .dynsym segment relative to .rodata
         RelativeSegment dynstr; //!< The .dynstr segment relative to .rodata
+
+        std::array<u8, 0x20> textHash{}; //!< The SHA-256 of .text supplied by the container of the executable, this is only valid if textHashSize is non-zero
+        size_t textHashSize{}; //!< The size of the prefix of .text which textHash covers, this is zero if the container doesn't supply a valid hash
     };
 }
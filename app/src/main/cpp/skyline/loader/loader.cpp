@@ -3,7 +3,9 @@
 
 #include <dlfcn.h>
 #include <cxxabi.h>
+#include <future>
 #include <nce.h>
+#include <nce/host_routines.h>
 #include <os.h>
 #include <kernel/types/KProcess.h>
 #include <kernel/memory.h>
@@ -14,8 +16,8 @@ namespace skyline::loader {
         u8 *base{reinterpret_cast<u8 *>(process->memory.base.address + offset)};
 
         u64 textSize{executable.text.contents.size()};
-        u64 roSize{executable.ro.contents.size()};
-        u64 dataSize{executable.data.contents.size() + executable.bssSize};
+        u64 roSize{executable.ro.Size()};
+        u64 dataSize{executable.data.Size() + executable.bssSize};
 
         if (!util::PageAligned(textSize) || !util::PageAligned(roSize) || !util::PageAligned(dataSize))
             throw exception("LoadProcessData: Sections are not aligned with page size: 0x{:X}, 0x{:X}, 0x{:X}", textSize, roSize, dataSize);
@@ -23,7 +25,7 @@ namespace skyline::loader {
         if (!util::PageAligned(executable.text.offset) || !util::PageAligned(executable.ro.offset) || !util::PageAligned(executable.data.offset))
             throw exception("LoadProcessData: Section offsets are not aligned with page size: 0x{:X}, 0x{:X}, 0x{:X}", executable.text.offset, executable.ro.offset, executable.data.offset);
 
-        auto patch{state.nce->GetPatchData(executable.text.contents)};
+        auto patch{state.nce->GetCachedPatchData(executable.text.contents, executable.textHash, executable.textHashSize)};
         auto size{patch.size + textSize + roSize + dataSize};
 
         process->NewHandle<kernel::type::KPrivateMemory>(base, patch.size, memory::Permission{false, false, false}, memory::states::Reserved); // ---
@@ -38,10 +40,21 @@ namespace skyline::loader {
         process->NewHandle<kernel::type::KPrivateMemory>(base + patch.size + executable.data.offset, dataSize, memory::Permission{true, true, false}, memory::states::CodeMutable); // RW-
         state.logger->Debug("Successfully mapped section .data + .bss @ 0x{:X}, Size = 0x{:X}", base + patch.size + executable.data.offset, dataSize);
 
+        // Segments with a load function are written into guest memory on their own threads while .text is being patched
+        std::vector<std::future<void>> segmentLoads;
+        for (auto segment : {&executable.ro, &executable.data}) {
+            u8 *destination{base + patch.size + segment->offset};
+            if (segment->load)
+                segmentLoads.push_back(std::async(std::launch::async, segment->load, span(destination, segment->size)));
+            else
+                std::memcpy(destination, segment->contents.data(), segment->contents.size());
+        }
+
         state.nce->PatchCode(executable.text.contents, reinterpret_cast<u32 *>(base), patch.size, patch.offsets);
         std::memcpy(base + patch.size + executable.text.offset, executable.text.contents.data(), textSize);
-        std::memcpy(base + patch.size + executable.ro.offset, executable.ro.contents.data(), roSize);
-        std::memcpy(base + patch.size + executable.data.offset, executable.data.contents.data(), dataSize - executable.bssSize);
+
+        for (auto &segmentLoad : segmentLoads)
+            segmentLoad.get(); // Any exceptions thrown while loading a segment are rethrown here
 
         auto rodataOffset{base + patch.size + executable.ro.offset};
         ExecutableSymbolicInfo symbolicInfo{
@@ -53,7 +66,24 @@ namespace skyline::loader {
             .symbols = span(reinterpret_cast<Elf64_Sym *>(rodataOffset + executable.dynsym.offset), executable.dynsym.size / sizeof(Elf64_Sym)),
             .symbolStrings = span(reinterpret_cast<char *>(rodataOffset + executable.dynstr.offset), executable.dynstr.size),
         };
-        executables.insert(std::upper_bound(executables.begin(), executables.end(), base, [](void *ptr, const ExecutableSymbolicInfo &it) { return ptr < it.patchStart; }), symbolicInfo);
+
+        auto &ranges{symbolicInfo.symbolRanges};
+        ranges.reserve(symbolicInfo.symbols.size());
+        for (const auto &symbol : symbolicInfo.symbols)
+            if (symbol.st_size)
+                ranges.push_back({symbol.st_value, symbol.st_value + symbol.st_size, 0, symbol.st_name < symbolicInfo.symbolStrings.size() ? symbol.st_name : 0});
+
+        // Named symbols are sorted before unnamed ones starting at the same address so that deduplication keeps them
+        std::stable_sort(ranges.begin(), ranges.end(), [](const auto &a, const auto &b) { return a.start < b.start || (a.start == b.start && a.name && !b.name); });
+        ranges.erase(std::unique(ranges.begin(), ranges.end(), [](const auto &a, const auto &b) { return a.start == b.start; }), ranges.end());
+
+        u64 maxEnd{};
+        for (auto &range : ranges)
+            range.maxEnd = maxEnd = std::max(maxEnd, range.end);
+
+        nce::HostRoutines::Replace(state, executables.size(), base + patch.size, symbolicInfo.symbols, symbolicInfo.symbolStrings);
+
+        executables.insert(std::upper_bound(executables.begin(), executables.end(), base, [](void *ptr, const ExecutableSymbolicInfo &it) { return ptr < it.patchStart; }), std::move(symbolicInfo));
 
         return {base, size, base + patch.size};
     }
@@ -62,13 +92,15 @@ namespace skyline::loader {
         auto executable{std::lower_bound(executables.begin(), executables.end(), ptr, [](const ExecutableSymbolicInfo &it, void *ptr) { return it.programEnd < ptr; })};
         if (executable != executables.end() && ptr >= executable->patchStart && ptr <= executable->programEnd) {
             if (ptr >= executable->programStart) {
-                auto offset{reinterpret_cast<u8 *>(ptr) - reinterpret_cast<u8 *>(executable->programStart)};
-                auto symbol{std::find_if(executable->symbols.begin(), executable->symbols.end(), [&offset](const Elf64_Sym &sym) { return sym.st_value <= offset && sym.st_value + sym.st_size > offset; })};
-                if (symbol != executable->symbols.end() && symbol->st_name && symbol->st_name < executable->symbolStrings.size()) {
-                    return {executable->symbolStrings.data() + symbol->st_name, executable->name};
-                } else {
-                    return {.executableName = executable->name};
-                }
+                auto offset{static_cast<u64>(reinterpret_cast<u8 *>(ptr) - reinterpret_cast<u8 *>(executable->programStart))};
+                const auto &ranges{executable->symbolRanges};
+                auto symbol{std::upper_bound(ranges.begin(), ranges.end(), offset, [](u64 offset, const auto &range) { return offset < range.start; })}; // The first symbol starting after the offset
+
+                // The closest symbol starting at or before the offset might end before it or be unnamed, in which case an earlier symbol may still enclose it
+                while (symbol != ranges.begin() && std::prev(symbol)->maxEnd > offset)
+                    if ((--symbol)->end > offset && symbol->name)
+                        return {executable->symbolStrings.data() + symbol->name, executable->name};
+                return {.executableName = executable->name};
             } else {
                 return {.executableName = executable->patchName};
             }
@@ -60,6 +60,17 @@ namespace skyline::loader {
             std::string patchName; //!< The name of the patch section
             span<Elf64_Sym> symbols; //!< A span over the .dynsym section
             span<char> symbolStrings; //!< A span over the .dynstr section
+
+            /**
+             * @brief The range of a symbol relative to programStart
+             */
+            struct SymbolRange {
+                u64 start;
+                u64 end;
+                u64 maxEnd; //!< The largest end of this range or any range before it, this bounds the search for a symbol enclosing an address
+                u32 name; //!< The offset of the symbol's name in .dynstr, this is 0 if the symbol has no valid name
+            };
+            std::vector<SymbolRange> symbolRanges; //!< All symbols with a non-zero size sorted by their start address, if symbols start at the same address then only the first named one in .dynsym is present
         };
 
         std::vector<ExecutableSymbolicInfo> executables;
@@ -16,17 +16,33 @@ namespace skyline::loader {
 
     std::vector<u8> NsoLoader::GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize) {
         std::vector<u8> outputBuffer(segment.decompressedSize);
+        ReadSegment(backing, segment, compressedSize, outputBuffer);
+        return outputBuffer;
+    }
 
+    void NsoLoader::ReadSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize, span<u8> output) {
         if (compressedSize) {
             std::vector<u8> compressedBuffer(compressedSize);
             backing->Read(compressedBuffer, segment.fileOffset);
 
-            LZ4_decompress_safe(reinterpret_cast<char *>(compressedBuffer.data()), reinterpret_cast<char *>(outputBuffer.data()), compressedSize, segment.decompressedSize);
+            if (LZ4_decompress_safe(reinterpret_cast<char *>(compressedBuffer.data()), reinterpret_cast<char *>(output.data()), compressedSize, segment.decompressedSize) != static_cast<int>(segment.decompressedSize))
+                throw exception("Failed to decompress NSO segment at 0x{:X}", segment.fileOffset);
         } else {
-            backing->Read(outputBuffer, segment.fileOffset);
+            backing->Read(output.first(segment.decompressedSize), segment.fileOffset);
         }
+    }
 
-        return outputBuffer;
+    Executable::Segment NsoLoader::GetLazySegment(const std::shared_ptr<vfs::Backing> &backing, const DeviceState &state, const NsoSegmentHeader &segment, u32 compressedSize, std::string_view name) {
+        return Executable::Segment{
+            .offset = segment.memoryOffset,
+            .size = segment.decompressedSize,
+            .load = [backing, &state, segment, compressedSize, name](span<u8> output) {
+                auto startTime{util::GetTimeNs()};
+                ReadSegment(backing, segment, compressedSize, output);
+                auto duration{std::max<u64>(util::GetTimeNs() - startTime, 1)};
+                state.logger->Debug("Loaded NSO segment {} (0x{:X} bytes) in {}us: {} MiB/s", name, segment.decompressedSize, duration / constant::NsInMicrosecond, (static_cast<u64>(segment.decompressedSize) * constant::NsInSecond) / (duration * 1024 * 1024));
+            },
+        };
     }
 
     Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name) {
@@ -40,16 +56,20 @@ namespace skyline::loader {
         executable.text.contents = GetSegment(backing, header.text, header.flags.textCompressed ? header.textCompressedSize : 0);
         executable.text.contents.resize(util::AlignUp(executable.text.contents.size(), PAGE_SIZE));
         executable.text.offset = header.text.memoryOffset;
+        if (header.flags.textHash) {
+            // The hash is of the uncompressed .text prior to alignment, it's used to look up the patch data without hashing .text again
+            std::memcpy(executable.textHash.data(), header.segmentHashes[0].data(), executable.textHash.size());
+            executable.textHashSize = header.text.decompressedSize;
+        }
 
-        executable.ro.contents = GetSegment(backing, header.ro, header.flags.roCompressed ? header.roCompressedSize : 0);
-        executable.ro.contents.resize(util::AlignUp(executable.ro.contents.size(), PAGE_SIZE));
-        executable.ro.offset = header.ro.memoryOffset;
+        // .rodata and .data don't need to be patched, so they're decompressed directly into guest memory while .text is being patched
+        executable.ro = GetLazySegment(backing, state, header.ro, header.flags.roCompressed ? header.roCompressedSize : 0, ".rodata");
+        executable.ro.size = util::AlignUp(executable.ro.size, PAGE_SIZE);
 
-        executable.data.contents = GetSegment(backing, header.data, header.flags.dataCompressed ? header.dataCompressedSize : 0);
-        executable.data.offset = header.data.memoryOffset;
+        executable.data = GetLazySegment(backing, state, header.data, header.flags.dataCompressed ? header.dataCompressedSize : 0, ".data");
 
         // Data and BSS are aligned together
-        executable.bssSize = util::AlignUp(executable.data.contents.size() + header.bssSize, PAGE_SIZE) - executable.data.contents.size();
+        executable.bssSize = util::AlignUp(executable.data.size + header.bssSize, PAGE_SIZE) - executable.data.size;
 
         if (header.dynsym.offset + header.dynsym.size <= header.ro.decompressedSize && header.dynstr.offset + header.dynstr.size <= header.ro.decompressedSize) {
             executable.dynsym = {header.dynsym.offset, header.dynsym.size};
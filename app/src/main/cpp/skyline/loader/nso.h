@@ -77,6 +77,17 @@ namespace skyline::loader {
          */
         static std::vector<u8> GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize);
 
+        /**
+         * @brief Reads the specified segment from the backing directly into the supplied buffer and decompresses it if needed
+         * @param output The buffer to write the segment into, it must be at least as large as the decompressed size of the segment
+         */
+        static void ReadSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize, span<u8> output);
+
+        /**
+         * @return An executable segment which is decompressed directly into guest memory when it's loaded
+         */
+        static Executable::Segment GetLazySegment(const std::shared_ptr<vfs::Backing> &backing, const DeviceState &state, const NsoSegmentHeader &segment, u32 compressedSize, std::string_view name);
+
       public:
         NsoLoader(std::shared_ptr<vfs::Backing> backing);
 
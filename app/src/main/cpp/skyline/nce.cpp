@@ -2,13 +2,20 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <cxxabi.h>
+#include <thread>
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 #include <unistd.h>
+#include <mbedtls/sha256.h>
 #include "common/signal.h"
 #include "common/trace.h"
 #include "os.h"
+#include "vfs/os_filesystem.h"
 #include "jvm.h"
 #include "kernel/types/KProcess.h"
 #include "kernel/svc.h"
+#include "kernel/svc_profiler.h"
 #include "nce/guest.h"
 #include "nce/instructions.h"
 #include "nce.h"
@@ -22,7 +29,13 @@ namespace skyline::nce {
         try {
             if (svc) [[likely]] {
                 TRACE_EVENT("kernel", perfetto::StaticString{svc.name});
-                (svc.function)(state);
+                if (kernel::SvcProfiler::Enabled) [[unlikely]] {
+                    auto startTime{util::GetTimeNs()};
+                    (svc.function)(state);
+                    kernel::SvcProfiler::Record(svcId, util::GetTimeNs() - startTime);
+                } else {
+                    (svc.function)(state);
+                }
             } else {
                 throw exception("Unimplemented SVC 0x{:X}", svcId);
             }
@@ -60,6 +73,9 @@ namespace skyline::nce {
     }
 
     void NCE::SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls) {
+        if (kernel::DirtyTracker::HandleFault(signal, info, ctx))
+            return; // Writes to pages protected by the dirty tracker are retried after being recorded, this applies to both guest and host code
+
         if (*tls) { // If TLS was restored then this occurred in guest code
             auto &mctx{ctx->uc_mcontext};
             const auto &state{*reinterpret_cast<ThreadContext *>(*tls)->state};
@@ -104,6 +120,7 @@ namespace skyline::nce {
 
     NCE::NCE(const DeviceState &state) : state(state) {
         signal::SetTlsRestorer(&NceTlsRestorer);
+        kernel::SvcProfiler::Enabled = state.settings->profileSvcs;
     }
 
     constexpr u8 MainSvcTrampolineSize{17}; // Size of the main SVC trampoline function in u32 units
@@ -114,48 +131,239 @@ namespace skyline::nce {
     constexpr u32 CntvctEl0{0x5F02};        // ID of CNTVCT_EL0 in MRS
     constexpr u32 TegraX1Freq{19200000};    // The clock frequency of the Tegra X1 (19.2 MHz)
 
-    NCE::PatchData NCE::GetPatchData(const std::vector<u8> &text) {
-        size_t size{guest::SaveCtxSize + guest::LoadCtxSize + MainSvcTrampolineSize};
-        std::vector<size_t> offsets;
+    /**
+     * @return If the instruction could be an SVC, MRS or MSR, this is a cheap filter for the full checks in ScanInstructions
+     */
+    static constexpr bool IsPatchCandidate(u32 instruction) {
+        return (instruction & 0xFFE0001F) == 0xD4000001 || (instruction & 0xFFD00000) == 0xD5100000; // SVC, MRS or MSR
+    }
 
-        u64 frequency = 26000000;
-        //asm("MRS %0, CNTFRQ_EL0" : "=r"(frequency));
-        bool rescaleClock{frequency != TegraX1Freq};
+    /**
+     * @brief Finds all instructions that need to be patched in a range of .text
+     * @param size The amount of instructions required in .patch, this is incremented for every instruction found
+     * @param offsets The offsets of any instructions found relative to the start of .text are appended to this
+     */
+    static void ScanInstructions(const u32 *text, const u32 *start, const u32 *end, bool rescaleClock, size_t &size, std::vector<size_t> &offsets) {
+        auto scan{[&](const u32 *instruction) {
+            if (!IsPatchCandidate(*instruction))
+                return;
 
-        auto start{reinterpret_cast<const u32 *>(text.data())}, end{reinterpret_cast<const u32 *>(text.data() + text.size())};
-        for (const u32 *instruction{start}; instruction < end; instruction++) {
             auto svc{*reinterpret_cast<const instructions::Svc *>(instruction)};
             auto mrs{*reinterpret_cast<const instructions::Mrs *>(instruction)};
             auto msr{*reinterpret_cast<const instructions::Msr *>(instruction)};
 
             if (svc.Verify()) {
                 size += 7;
-                offsets.push_back(instruction - start);
+                offsets.push_back(instruction - text);
             } else if (mrs.Verify()) {
                 if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
                     size += ((mrs.destReg != registers::X0) ? 6 : 3);
-                    offsets.push_back(instruction - start);
+                    offsets.push_back(instruction - text);
                 } else {
                     if (rescaleClock) {
                         if (mrs.srcReg == CntpctEl0) {
                             size += guest::RescaleClockSize + 3;
-                            offsets.push_back(instruction - start);
+                            offsets.push_back(instruction - text);
                         } else if (mrs.srcReg == CntfrqEl0) {
                             size += 3;
-                            offsets.push_back(instruction - start);
+                            offsets.push_back(instruction - text);
                         }
                     } else if (mrs.srcReg == CntpctEl0) {
-                        offsets.push_back(instruction - start);
+                        offsets.push_back(instruction - text);
                     }
                 }
             } else if (msr.Verify() && msr.destReg == TpidrEl0) {
                 size += 6;
-                offsets.push_back(instruction - start);
+                offsets.push_back(instruction - text);
             }
+        }};
+
+        const u32 *instruction{start};
+        #ifdef __ARM_NEON
+        // Candidates are sparse in .text, so blocks of 8 instructions are filtered at once and only blocks with a candidate are checked individually
+        auto svcMask{vdupq_n_u32(0xFFE0001F)}, svcValue{vdupq_n_u32(0xD4000001)};
+        auto sysMask{vdupq_n_u32(0xFFD00000)}, sysValue{vdupq_n_u32(0xD5100000)};
+        for (; instruction + 8 <= end; instruction += 8) {
+            auto low{vld1q_u32(instruction)}, high{vld1q_u32(instruction + 4)};
+            auto matches{vorrq_u32(
+                vorrq_u32(vceqq_u32(vandq_u32(low, svcMask), svcValue), vceqq_u32(vandq_u32(low, sysMask), sysValue)),
+                vorrq_u32(vceqq_u32(vandq_u32(high, svcMask), svcValue), vceqq_u32(vandq_u32(high, sysMask), sysValue))
+            )};
+            if (vmaxvq_u32(matches))
+                for (auto candidate{instruction}; candidate < instruction + 8; candidate++)
+                    scan(candidate);
+        }
+        #endif
+
+        for (; instruction < end; instruction++)
+            scan(instruction);
+    }
+
+    constexpr size_t PatchScanThreadMinimumSize{0x100000}; //!< The minimum amount of .text in bytes that each thread scans when splitting a scan across threads
+
+    NCE::PatchData NCE::GetPatchData(const std::vector<u8> &text) {
+        size_t size{guest::SaveCtxSize + guest::LoadCtxSize + MainSvcTrampolineSize};
+        std::vector<size_t> offsets;
+
+        u64 frequency = 26000000;
+        //asm("MRS %0, CNTFRQ_EL0" : "=r"(frequency));
+        bool rescaleClock{frequency != TegraX1Freq};
+
+        auto start{reinterpret_cast<const u32 *>(text.data())}, end{reinterpret_cast<const u32 *>(text.data() + text.size())};
+        auto instructionCount{static_cast<size_t>(end - start)};
+        auto threadCount{std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1U), (text.size() / PatchScanThreadMinimumSize) + 1)};
+        if (threadCount == 1) {
+            ScanInstructions(start, start, end, rescaleClock, size, offsets);
+            return {util::AlignUp(size * sizeof(u32), PAGE_SIZE), offsets};
+        }
+
+        // Each thread scans a contiguous slice of .text, the results are merged in the order of the slices so the offsets are identical to a single-threaded scan
+        struct ScanResult {
+            size_t size{};
+            std::vector<size_t> offsets;
+        };
+        std::vector<ScanResult> results(threadCount);
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+
+        auto sliceSize{(instructionCount + threadCount - 1) / threadCount};
+        for (size_t index{}; index < threadCount; index++) {
+            auto sliceStart{start + std::min(index * sliceSize, instructionCount)}, sliceEnd{start + std::min((index + 1) * sliceSize, instructionCount)};
+            auto &result{results[index]};
+            if (index == threadCount - 1)
+                ScanInstructions(start, sliceStart, sliceEnd, rescaleClock, result.size, result.offsets); // The calling thread scans the last slice itself
+            else
+                threads.emplace_back(ScanInstructions, start, sliceStart, sliceEnd, rescaleClock, std::ref(result.size), std::ref(result.offsets));
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        for (const auto &result : results) {
+            size += result.size;
+            offsets.insert(offsets.end(), result.offsets.begin(), result.offsets.end());
         }
         return {util::AlignUp(size * sizeof(u32), PAGE_SIZE), offsets};
     }
 
+    /**
+     * @brief The header of a patch cache entry, it's followed by the patch offsets
+     */
+    struct PatchCacheHeader {
+        u32 magic; //!< PatchCacheMagic
+        u32 version; //!< NCE::PatchCacheVersion
+        std::array<u8, 0x20> textHash; //!< The SHA-256 of .text which the entry was generated from
+        u64 textSize; //!< The size of .text which the entry was generated from
+        u64 patchSize; //!< The size of the .patch section
+        u64 offsetCount; //!< The amount of offsets following the header
+        u8 rescaleClock; //!< If the entry was generated with clock rescaling enabled, this changes which instructions are patched
+        u8 _pad_[7];
+    };
+    static_assert(sizeof(PatchCacheHeader) == 0x48);
+
+    constexpr u32 PatchCacheMagic{util::MakeMagic<u32>("NCEP")};
+
+    /**
+     * @return The SHA-256 of the supplied data
+     */
+    static std::array<u8, 0x20> HashText(span<const u8> text) {
+        std::array<u8, 0x20> hash;
+        if (int err{mbedtls_sha256(text.data(), text.size(), hash.data(), 0)}; err < 0)
+            throw exception("Failed to hash .text: {}", err);
+        return hash;
+    }
+
+    NCE::PatchData NCE::GetCachedPatchData(const std::vector<u8> &text, std::array<u8, 0x20> textHash, size_t textHashSize) {
+        u64 frequency = 26000000;
+        //asm("MRS %0, CNTFRQ_EL0" : "=r"(frequency));
+        bool rescaleClock{frequency != TegraX1Freq};
+
+        auto startTime{util::GetTimeNs()};
+        if (!textHashSize) // Executables without a hash in their header, such as NROs, need to have .text hashed
+            textHash = HashText(text);
+
+        auto getPath{[](const std::array<u8, 0x20> &hash) {
+            std::string path;
+            for (auto byte : hash)
+                path += fmt::format("{:02X}", byte);
+            return path + ".bin";
+        }};
+        auto path{getPath(textHash)};
+
+        std::optional<vfs::OsFileSystem> cache;
+        auto readCache{[&]() -> std::optional<PatchData> {
+            try {
+                if (!cache)
+                    cache.emplace(state.os->appFilesPath + "/nce_cache/");
+                if (cache->FileExists(path)) {
+                    auto file{cache->OpenFile(path)};
+                    if (file->size >= sizeof(PatchCacheHeader)) {
+                        auto header{file->Read<PatchCacheHeader>()};
+                        if (header.magic == PatchCacheMagic && header.version == PatchCacheVersion && header.textHash == textHash && header.textSize == text.size() && header.rescaleClock == rescaleClock && file->size == sizeof(PatchCacheHeader) + header.offsetCount * sizeof(u64)) {
+                            PatchData patch{header.patchSize, std::vector<size_t>(header.offsetCount)};
+                            file->Read(span(patch.offsets).cast<u8>(), sizeof(PatchCacheHeader));
+                            state.logger->Info("Loaded NCE patch data for .text {} from the cache in {}us", path, (util::GetTimeNs() - startTime) / constant::NsInMicrosecond);
+                            return patch;
+                        }
+                    }
+                }
+            } catch (const std::exception &e) {
+                state.logger->Warn("Failed to read NCE patch data from the cache: {}", e.what()); // The cache is only an optimization, failing to access it shouldn't prevent the executable from loading
+            }
+            return std::nullopt;
+        }};
+
+        if (auto patch{readCache()})
+            return *patch;
+
+        // A hash from the executable's header is verified prior to an entry being created for it, otherwise an executable with a stale hash would insert patch data for different code under the hash of the original
+        if (textHashSize) {
+            if (textHashSize > text.size() || HashText(span(text).first(textHashSize)) != textHash) {
+                state.logger->Warn("The .text hash in the header of the executable doesn't match its contents, it's hashed in its entirety instead");
+                textHash = HashText(text);
+                path = getPath(textHash);
+                if (auto patch{readCache()})
+                    return *patch;
+            }
+        }
+
+        auto patch{GetPatchData(text)};
+        state.logger->Info("Generated NCE patch data for .text {} in {}us", path, (util::GetTimeNs() - startTime) / constant::NsInMicrosecond);
+        if (!cache)
+            return patch;
+
+        static_assert(sizeof(size_t) == sizeof(u64));
+        PatchCacheHeader header{
+            .magic = PatchCacheMagic,
+            .version = PatchCacheVersion,
+            .textHash = textHash,
+            .textSize = text.size(),
+            .patchSize = patch.size,
+            .offsetCount = patch.offsets.size(),
+            .rescaleClock = rescaleClock,
+        };
+        auto size{sizeof(PatchCacheHeader) + patch.offsets.size() * sizeof(u64)};
+        try {
+            // The entry is written to a temporary file which is renamed over the entry once it's complete, so an entry is never observed partially written even if the process dies during the write
+            auto temporaryPath{path + ".tmp"};
+            if (cache->CreateFile(temporaryPath, size)) {
+                {
+                    auto file{cache->OpenFile(temporaryPath, {true, true, false})};
+                    file->Write(span(patch.offsets).cast<u8>(), sizeof(PatchCacheHeader));
+                    file->WriteObject(header);
+                }
+
+                auto cachePath{state.os->appFilesPath + "/nce_cache/"};
+                if (rename((cachePath + temporaryPath).c_str(), (cachePath + path).c_str()) < 0)
+                    throw exception("Failed to rename {} to {}: {}", temporaryPath, path, strerror(errno));
+            }
+        } catch (const std::exception &e) {
+            state.logger->Warn("Failed to write NCE patch data to the cache: {}", e.what());
+        }
+
+        return patch;
+    }
+
     void NCE::PatchCode(std::vector<u8> &text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets) {
         u32 *start{patch};
         u32 *end{patch + (patchSize / sizeof(u32))};
@@ -28,6 +28,18 @@ namespace skyline::nce {
 
         static PatchData GetPatchData(const std::vector<u8> &text);
 
+        static constexpr u32 PatchCacheVersion{2}; //!< The version of the patch cache format and the patcher, this must be incremented whenever GetPatchData or PatchCode change the offsets they use
+
+        /**
+         * @brief Retrieves the patch data for the supplied .text from the on-disk patch cache or scans it with GetPatchData and inserts the result into the cache
+         * @param textHash The SHA-256 of .text from the executable's header, this is only used if textHashSize is non-zero
+         * @param textHashSize The size of the prefix of .text which textHash covers, .text is hashed in its entirety if this is zero
+         * @note The cache is keyed by the SHA-256 of .text and PatchCacheVersion, entries from other versions are treated as misses and overwritten
+         * @note A hash from the header is verified against .text before an entry is created for it, a cache hit isn't verified as that would require hashing .text on every load
+         * @note The cache is only an optimization, any error while accessing it is logged and the patch data is generated instead
+         */
+        PatchData GetCachedPatchData(const std::vector<u8> &text, std::array<u8, 0x20> textHash, size_t textHashSize);
+
         /**
          * @brief Writes the .patch section and mutates the code accordingly
          * @param patch A pointer to the .patch section which should be exactly patchSize in size and located before the .text section
@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/mman.h>
+#include <common/settings.h>
+#include <kernel/types/KProcess.h>
+#include "host_routines.h"
+
+namespace skyline::nce {
+    /**
+     * @brief The routines which can be replaced, these index HostRoutineTable and every executable's entry in GuestRoutines and are used as bits in HostRoutineAllowlistEntry::routines
+     */
+    enum class HostRoutine : u8 {
+        Memcpy,
+        Memmove,
+        Memset,
+        Memcmp,
+        Strlen,
+        Count,
+    };
+
+    struct HostRoutineAllowlistEntry {
+        u64 programId;
+        u32 routines; //!< A bitmask of the HostRoutines which can be replaced for the title
+    };
+
+    /**
+     * @brief All titles which can have their routines replaced without validation, entries should only be added after the title has been run without any mismatches with validation enabled
+     */
+    constexpr std::array<HostRoutineAllowlistEntry, 0> HostRoutineAllowlist{};
+
+    constexpr size_t MaxValidatedExecutables{16}; //!< The amount of executables which can have their routines validated, titles have at most 13 (rtld, main, subsdk0-9 and sdk)
+
+    /**
+     * @brief Relocated copies of the guest routines of every executable, validators are instantiated for every executable so each of them validates against the copy from its own executable
+     */
+    std::array<std::array<void *, static_cast<size_t>(HostRoutine::Count)>, MaxValidatedExecutables> GuestRoutines{};
+
+    constexpr size_t ValidationLimit{0x400}; //!< The largest call that is validated, the results of the guest routine are written into a buffer on the guest stack so larger calls are only run on the host
+
+    // Validators run on the guest stack with the guest TPIDR_EL0, they cannot allocate, log or use the stack protector and report mismatches by trapping which is handled as a guest crash
+    #define VALIDATOR __attribute__((no_stack_protector))
+
+    template<size_t Executable>
+    VALIDATOR void *ValidateMemcpy(void *destination, const void *source, size_t size) {
+        if (size > ValidationLimit)
+            return std::memcpy(destination, source, size);
+
+        u8 expected[ValidationLimit];
+        reinterpret_cast<void *(*)(void *, const void *, size_t)>(GuestRoutines[Executable][static_cast<size_t>(HostRoutine::Memcpy)])(expected, source, size);
+        std::memcpy(destination, source, size);
+        if (std::memcmp(destination, expected, size) != 0)
+            __builtin_trap();
+        return destination;
+    }
+
+    template<size_t Executable>
+    VALIDATOR void *ValidateMemmove(void *destination, const void *source, size_t size) {
+        if (size > ValidationLimit)
+            return std::memmove(destination, source, size);
+
+        u8 expected[ValidationLimit]; // The source is moved into the buffer prior to the host move as the ranges may overlap
+        reinterpret_cast<void *(*)(void *, const void *, size_t)>(GuestRoutines[Executable][static_cast<size_t>(HostRoutine::Memmove)])(expected, source, size);
+        std::memmove(destination, source, size);
+        if (std::memcmp(destination, expected, size) != 0)
+            __builtin_trap();
+        return destination;
+    }
+
+    template<size_t Executable>
+    VALIDATOR void *ValidateMemset(void *destination, int value, size_t size) {
+        if (size > ValidationLimit)
+            return std::memset(destination, value, size);
+
+        u8 expected[ValidationLimit];
+        reinterpret_cast<void *(*)(void *, int, size_t)>(GuestRoutines[Executable][static_cast<size_t>(HostRoutine::Memset)])(expected, value, size);
+        std::memset(destination, value, size);
+        if (std::memcmp(destination, expected, size) != 0)
+            __builtin_trap();
+        return destination;
+    }
+
+    template<size_t Executable>
+    VALIDATOR int ValidateMemcmp(const void *a, const void *b, size_t size) {
+        auto expected{reinterpret_cast<int (*)(const void *, const void *, size_t)>(GuestRoutines[Executable][static_cast<size_t>(HostRoutine::Memcmp)])(a, b, size)};
+        auto result{std::memcmp(a, b, size)};
+        if ((expected < 0) != (result < 0) || (expected > 0) != (result > 0)) // Only the sign of the result is defined
+            __builtin_trap();
+        return result;
+    }
+
+    template<size_t Executable>
+    VALIDATOR size_t ValidateStrlen(const char *string) {
+        auto expected{reinterpret_cast<size_t (*)(const char *)>(GuestRoutines[Executable][static_cast<size_t>(HostRoutine::Strlen)])(string)};
+        auto result{std::strlen(string)};
+        if (expected != result)
+            __builtin_trap();
+        return result;
+    }
+
+    #undef VALIDATOR
+
+    struct HostRoutineInfo {
+        std::string_view name; //!< The name of the routine in .dynsym
+        void *host; //!< The host implementation of the routine
+    };
+
+    /**
+     * @note This is indexed by HostRoutine
+     */
+    const std::array<HostRoutineInfo, static_cast<size_t>(HostRoutine::Count)> HostRoutineTable{{
+        {"memcpy", reinterpret_cast<void *>(static_cast<void *(*)(void *, const void *, size_t)>(&std::memcpy))},
+        {"memmove", reinterpret_cast<void *>(static_cast<void *(*)(void *, const void *, size_t)>(&std::memmove))},
+        {"memset", reinterpret_cast<void *>(static_cast<void *(*)(void *, int, size_t)>(&std::memset))},
+        {"memcmp", reinterpret_cast<void *>(static_cast<int (*)(const void *, const void *, size_t)>(&std::memcmp))},
+        {"strlen", reinterpret_cast<void *>(static_cast<size_t (*)(const char *)>(&std::strlen))},
+    }};
+
+    template<size_t... Executables>
+    static auto MakeValidatorTable(std::index_sequence<Executables...>) {
+        return std::array<std::array<void *, static_cast<size_t>(HostRoutine::Count)>, sizeof...(Executables)>{{
+            {reinterpret_cast<void *>(&ValidateMemcpy<Executables>), reinterpret_cast<void *>(&ValidateMemmove<Executables>), reinterpret_cast<void *>(&ValidateMemset<Executables>), reinterpret_cast<void *>(&ValidateMemcmp<Executables>), reinterpret_cast<void *>(&ValidateStrlen<Executables>)}...
+        }};
+    }
+
+    /**
+     * @brief The validators of every routine for every executable, these are indexed by the executable and then by HostRoutine
+     */
+    const auto ValidatorTable{MakeValidatorTable(std::make_index_sequence<MaxValidatedExecutables>{})};
+
+    /**
+     * @return The supplied value sign-extended from the specified amount of bits
+     */
+    constexpr i64 SignExtend(u32 value, u8 bits) {
+        auto shift{64 - bits};
+        return static_cast<i64>(static_cast<u64>(value) << shift) >> shift;
+    }
+
+    constexpr size_t TrampolineSize{4 * sizeof(u32)}; //!< The size of the branch written over the entry of a guest routine
+
+    /**
+     * @return If the code of a routine only contains PC-relative branches to targets inside of it, this is required for it to be executed from a copy
+     */
+    static bool IsRelocatable(span<u32> code) {
+        for (size_t index{}; index < code.size(); index++) {
+            auto instruction{code[index]};
+            i64 offset;
+            if ((instruction & 0x1F000000) == 0x10000000 || (instruction & 0x3B000000) == 0x18000000)
+                return false; // ADR, ADRP and literal loads can't be relocated
+            else if ((instruction & 0x7C000000) == 0x14000000) // B and BL
+                offset = SignExtend(instruction & 0x3FFFFFF, 26);
+            else if ((instruction & 0xFF000010) == 0x54000000 || (instruction & 0x7E000000) == 0x34000000) // B.cond, CBZ and CBNZ
+                offset = SignExtend((instruction >> 5) & 0x7FFFF, 19);
+            else if ((instruction & 0x7E000000) == 0x36000000) // TBZ and TBNZ
+                offset = SignExtend((instruction >> 5) & 0x3FFF, 14);
+            else
+                continue;
+
+            auto target{static_cast<i64>(index) + offset};
+            if (target < 0 || target >= static_cast<i64>(code.size()))
+                return false;
+        }
+        return true;
+    }
+
+    void HostRoutines::Replace(const DeviceState &state, size_t executable, u8 *programStart, span<Elf64_Sym> symbols, span<char> symbolStrings) {
+        if (!state.settings->hostLibcRoutines)
+            return;
+
+        // Validation replaces every routine of every title as any mismatch is caught, otherwise only the routines allowlisted for the title are replaced
+        bool validate{state.settings->validateHostLibcRoutines};
+        u32 allowedRoutines{(1U << static_cast<u32>(HostRoutine::Count)) - 1};
+        if (validate) {
+            if (executable >= MaxValidatedExecutables) {
+                state.logger->Warn("Cannot validate the routines of executable {}: Only {} executables can be validated", executable, MaxValidatedExecutables);
+                return;
+            }
+        } else {
+            auto programId{state.process->npdm.aci0.programId};
+            auto entry{std::find_if(HostRoutineAllowlist.begin(), HostRoutineAllowlist.end(), [programId](const HostRoutineAllowlistEntry &entry) { return entry.programId == programId; })};
+            if (entry == HostRoutineAllowlist.end())
+                return;
+            allowedRoutines = entry->routines;
+        }
+
+        for (const auto &symbol : symbols) {
+            if (ELF64_ST_TYPE(symbol.st_info) != STT_FUNC || symbol.st_shndx == SHN_UNDEF || !symbol.st_name || symbol.st_name >= symbolStrings.size())
+                continue;
+
+            std::string_view name{symbolStrings.data() + symbol.st_name, strnlen(symbolStrings.data() + symbol.st_name, symbolStrings.size() - symbol.st_name)};
+            auto routine{std::find_if(HostRoutineTable.begin(), HostRoutineTable.end(), [name](const HostRoutineInfo &routine) { return routine.name == name; })};
+            if (routine == HostRoutineTable.end())
+                continue;
+
+            auto index{static_cast<size_t>(std::distance(HostRoutineTable.begin(), routine))};
+            if (!(allowedRoutines & (1U << index)))
+                continue;
+
+            if (symbol.st_size < TrampolineSize || !util::IsAligned(symbol.st_size, sizeof(u32))) {
+                state.logger->Warn("Cannot replace guest {}: The routine is too small ({} bytes)", name, symbol.st_size);
+                continue;
+            }
+
+            auto guestCode{reinterpret_cast<u32 *>(programStart + symbol.st_value)};
+            if (validate) {
+                span<u32> code(guestCode, symbol.st_size / sizeof(u32));
+                if (!IsRelocatable(code)) {
+                    state.logger->Warn("Cannot validate guest {}: The routine can't be relocated", name);
+                    continue;
+                }
+
+                auto size{util::AlignUp(code.size_bytes(), PAGE_SIZE)};
+                auto copy{mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0)};
+                if (copy == MAP_FAILED)
+                    throw exception("Failed to allocate memory for a copy of guest {}: {}", name, strerror(errno));
+
+                std::memcpy(copy, code.data(), code.size_bytes());
+                if (mprotect(copy, size, PROT_READ | PROT_EXEC) < 0)
+                    throw exception("Failed to reprotect the copy of guest {}: {}", name, strerror(errno));
+                __builtin___clear_cache(reinterpret_cast<char *>(copy), reinterpret_cast<char *>(copy) + code.size_bytes());
+
+                GuestRoutines[executable][index] = copy;
+            }
+
+            // X16 is an intra-procedure-call scratch register which callers cannot expect to be preserved, so it can be clobbered by the trampoline
+            auto target{reinterpret_cast<u64>(validate ? ValidatorTable[executable][index] : routine->host)};
+            guestCode[0] = 0x58000050; // LDR X16, #8
+            guestCode[1] = 0xD61F0200; // BR X16
+            std::memcpy(guestCode + 2, &target, sizeof(u64));
+            __builtin___clear_cache(reinterpret_cast<char *>(guestCode), reinterpret_cast<char *>(guestCode) + TrampolineSize);
+
+            state.logger->Debug("Replaced guest {} @ 0x{:X} with the host routine{}", name, guestCode, validate ? " in validation mode" : "");
+        }
+    }
+}
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <linux/elf.h>
+#include <common.h>
+
+namespace skyline::nce {
+    /**
+     * @brief HostRoutines replaces hot libc routines in guest executables with the host's implementations, the entry of a guest routine is rewritten into a branch to the host routine
+     * @note This is only possible as the replaced routines are leaf functions which don't access TLS, so they can run on the guest stack with the guest value of TPIDR_EL0
+     * @note Only the routines in the allowlist entry for the title's program ID are replaced, this is overridden by the validation mode where every routine of every title is replaced
+     * @note In the validation mode every call is compared against a copy of the guest routine from the same executable, a mismatch traps and is handled as a guest crash
+     */
+    class HostRoutines {
+      public:
+        /**
+         * @brief Replaces all supported routines defined in the .dynsym of an executable if this is enabled in the settings
+         * @param executable The index of the executable in the process, every executable must have a unique index as its validators are specific to it
+         * @param programStart The address which the values of the symbols are relative to
+         * @note This must be called after the executable has been patched and written into guest memory
+         */
+        static void Replace(const DeviceState &state, size_t executable, u8 *programStart, span<Elf64_Sym> symbols, span<char> symbolStrings);
+    };
+}
@@ -4,7 +4,10 @@
 #include "nce.h"
 #include "nce/guest.h"
 #include "kernel/types/KProcess.h"
+#include "kernel/scheduler_harness.h"
 #include "vfs/os_backing.h"
+#include "vfs/mmap_backing.h"
+#include "vfs/cached_backing.h"
 #include "loader/nro.h"
 #include "loader/nso.h"
 #include "loader/nca.h"
@@ -16,7 +19,24 @@ namespace skyline::kernel {
     OS::OS(std::shared_ptr<JvmManager> &jvmManager, std::shared_ptr<Logger> &logger, std::shared_ptr<Settings> &settings, std::string appFilesPath, std::string deviceTimeZone, std::shared_ptr<vfs::FileSystem> assetFileSystem) : state(this, jvmManager, settings, logger), appFilesPath(std::move(appFilesPath)), deviceTimeZone(std::move(deviceTimeZone)), assetFileSystem(std::move(assetFileSystem)), serviceManager(state) {}
 
     void OS::Execute(int romFd, loader::RomFormat romType) {
-        auto romFile{std::make_shared<vfs::OsBacking>(romFd)};
+        #ifdef SCHEDULER_HARNESS
+        SchedulerHarness::Log(state, SchedulerHarness::Run(state, SchedulerHarness::Generate(SchedulerHarness::DefaultSeed)));
+        #endif
+
+        // ROMs are mapped into memory when possible as it avoids a syscall for every read, some file descriptors such as ones for pipes cannot be mapped so reading through syscalls is used as a fallback
+        std::shared_ptr<vfs::MmapBacking> mappedRomFile;
+        std::shared_ptr<vfs::Backing> romFile;
+        try {
+            romFile = mappedRomFile = std::make_shared<vfs::MmapBacking>(romFd);
+        } catch (const std::exception &e) {
+            state.logger->Warn("Falling back to reading the ROM through syscalls: {}", e.what());
+            mappedRomFile = nullptr;
+            romFile = std::make_shared<vfs::OsBacking>(romFd);
+        }
+
+        if (mappedRomFile)
+            mappedRomFile->Advise(state, vfs::MmapBacking::AccessPattern::Sequential); // Executables are read in large contiguous pieces during loading
+
         auto keyStore{std::make_shared<crypto::KeyStore>(appFilesPath)};
 
         state.loader = [&]() -> std::shared_ptr<loader::Loader> {
@@ -39,6 +59,8 @@ namespace skyline::kernel {
         auto &process{state.process};
         process = std::make_shared<kernel::type::KProcess>(state);
         auto entry{state.loader->LoadProcessData(process, state)};
+        if (mappedRomFile)
+            mappedRomFile->Advise(state, vfs::MmapBacking::AccessPattern::Random); // RomFS reads are scattered, any readahead for them is done by vfs::CachedBacking
         process->InitializeHeapTls();
         auto thread{process->CreateThread(entry)};
         if (thread) {
@@ -46,5 +68,9 @@ namespace skyline::kernel {
             thread->Start(true);
             process->Kill(true, true, true);
         }
+
+        auto cacheStatistics{vfs::BlockCache::Get().GetStatistics()};
+        if (auto lookups{cacheStatistics.hits + cacheStatistics.misses})
+            state.logger->Info("RomFS block cache: {}% hit ratio ({} hits, {} misses), {} KiB read at {} KiB/s", (cacheStatistics.hits * 100) / lookups, cacheStatistics.hits, cacheStatistics.misses, cacheStatistics.bytesRead / 1024, cacheStatistics.readDuration ? (cacheStatistics.bytesRead * constant::NsInSecond) / (cacheStatistics.readDuration * 1024) : 0);
     }
 }
@@ -6,6 +6,7 @@
 #include "vfs/filesystem.h"
 #include "loader/loader.h"
 #include "services/serviceman.h"
+#include "kernel/snapshot.h"
 
 namespace skyline::kernel {
     /**
@@ -18,6 +19,7 @@ namespace skyline::kernel {
         std::string deviceTimeZone; //!< The timezone name (e.g. Europe/London)
         std::shared_ptr<vfs::FileSystem> assetFileSystem; //!< A filesystem to be used for accessing emulator assets (like tzdata)
         service::ServiceManager serviceManager;
+        ProcessSnapshot snapshot; //!< The last state of the process saved by the user, this is restored on their request
 
         /**
          * @param logger An instance of the Logger class
@@ -24,6 +24,7 @@ namespace skyline::soc::gm20b {
         u32 argument;
         u32 subChannel;
         bool lastCall; //!< If this is the last call in the pushbuffer entry to this specific macro
+        u32 *argumentPointer{}; //!< A pointer to the argument inside the pushbuffer, this is null if the argument doesn't reside in the pushbuffer
     };
 
     namespace engine {
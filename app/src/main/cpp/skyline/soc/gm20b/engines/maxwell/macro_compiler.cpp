@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "macro_hle.h"
+
+namespace skyline::soc::gm20b::engine::maxwell3d {
+    size_t MacroCompiler::GetMacroLength(span<u32> macroCode, size_t offset) {
+        size_t remaining{macroCode.size() - offset};
+        size_t end{}; // The index after the furthest instruction that a branch can jump to
+
+        for (size_t index{}; index < remaining; index++) {
+            MacroInterpreter::Opcode opcode{.raw = macroCode[offset + index]};
+
+            if (opcode.operation == MacroInterpreter::Opcode::Operation::Branch) {
+                i64 target{static_cast<i64>(index) + opcode.immediate};
+                if (target >= 0)
+                    end = std::max(end, static_cast<size_t>(target) + 1);
+            }
+
+            // A macro ends after the delay slot of an exit instruction, unless it's possible to branch beyond it
+            if (opcode.exit && index + 2 >= end)
+                return std::min(index + 2, remaining);
+        }
+
+        return remaining;
+    }
+
+    std::shared_ptr<MacroProgram> MacroCompiler::Compile(span<u32> code, size_t hash) {
+        auto program{std::make_shared<MacroProgram>()};
+        program->hash = hash;
+        program->hle = MacroHle::Find(hash);
+        program->code.assign(code.begin(), code.end());
+        program->instructions.reserve(code.size());
+
+        for (size_t index{}; index < code.size(); index++) {
+            MacroInterpreter::Opcode opcode{.raw = code[index]};
+
+            bool isBranch{opcode.operation == MacroInterpreter::Opcode::Operation::Branch};
+            program->instructions.push_back(MacroInstruction{
+                .operation = opcode.operation,
+                .assignmentOperation = opcode.assignmentOperation,
+                .aluOperation = opcode.aluOperation,
+                .branchCondition = opcode.branchCondition,
+                .noDelay = opcode.noDelay,
+                .exit = static_cast<bool>(opcode.exit),
+                .dest = opcode.dest,
+                .srcA = opcode.srcA,
+                .srcB = opcode.srcB,
+                .srcBit = opcode.bitfield.srcBit,
+                .destBit = opcode.bitfield.destBit,
+                .mask = opcode.bitfield.GetMask(),
+                .immediate = isBranch ? static_cast<i32>(index) + opcode.immediate : opcode.immediate,
+            });
+        }
+
+        return program;
+    }
+
+    MacroProgram &MacroCompiler::Get(size_t index, size_t offset, span<u32> macroCode) {
+        if (dirty) {
+            for (auto &slot : slots)
+                slot.program = nullptr;
+            dirty = false;
+        }
+
+        auto &slot{slots.at(index)};
+        if (slot.program && slot.offset == offset)
+            return *slot.program;
+
+        if (offset >= macroCode.size())
+            throw exception("Macro offset is outside of macro memory: 0x{:X}", offset);
+
+        auto code{macroCode.subspan(offset, GetMacroLength(macroCode, offset))};
+        size_t hash{util::Hash(code.as_string())};
+
+        // Titles which continuously upload new macros would otherwise grow the cache without bound, programs which are still bound to a position are retained as they're in use
+        if (cache.size() >= MaxCachedPrograms && !cache.contains(hash))
+            std::erase_if(cache, [](const auto &entry) { return entry.second.use_count() == 1; });
+
+        auto &program{cache[hash]};
+        if (!program || !std::equal(program->code.begin(), program->code.end(), code.begin(), code.end()))
+            program = Compile(code, hash);
+
+        slot = MacroSlot{offset, program};
+        return *program;
+    }
+}
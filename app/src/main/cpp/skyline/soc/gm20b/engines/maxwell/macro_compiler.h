@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "macro_interpreter.h"
+
+namespace skyline::soc::gm20b::engine::maxwell3d {
+    /**
+     * @brief A single macro instruction with all of its fields extracted from the packed opcode ahead of time
+     */
+    struct MacroInstruction {
+        using Opcode = MacroInterpreter::Opcode;
+
+        Opcode::Operation operation;
+        Opcode::AssignmentOperation assignmentOperation;
+        Opcode::AluOperation aluOperation;
+        Opcode::BranchCondition branchCondition;
+        bool noDelay;
+        bool exit;
+        u8 dest;
+        u8 srcA;
+        u8 srcB;
+        u8 srcBit;
+        u8 destBit;
+        u32 mask; //!< The bitfield mask, this is pre-computed from the size of the bitfield
+        i32 immediate; //!< The immediate value of the instruction, branches have this converted into an absolute index into the program
+    };
+
+    struct MacroJitCode;
+
+    /**
+     * @brief A native implementation of a macro, it must have the same effect on the Maxwell 3D as executing the macro would
+     */
+    using MacroHleFunction = void (*)(Maxwell3D &maxwell3D, span<u32> args);
+
+    /**
+     * @brief A macro which has been translated from macro memory into an array of pre-decoded instructions
+     */
+    struct MacroProgram {
+        size_t hash; //!< A hash of the macro code this program was compiled from
+        std::vector<u32> code; //!< A copy of the macro code this program was compiled from, this is used to verify that cache hits aren't hash collisions
+        std::vector<MacroInstruction> instructions;
+        MacroHleFunction hle; //!< A native implementation of this program found by the hash of its code, this is null if there isn't one
+        std::shared_ptr<MacroJitCode> native; //!< The host code generated for this program by the MacroJit, this is null if the program couldn't be compiled into host code
+        bool nativeAttempted{}; //!< If the MacroJit has attempted to compile this program into host code
+    };
+
+    /**
+     * @brief The MacroCompiler class translates macros in macro memory into MacroPrograms and caches them by the hash of their code
+     */
+    class MacroCompiler {
+      private:
+        static constexpr size_t MaxCachedPrograms{0x200}; //!< The amount of programs the cache can hold before programs which aren't bound to a macro position are evicted from it
+        std::unordered_map<size_t, std::shared_ptr<MacroProgram>> cache; //!< A cache of compiled programs indexed by the hash of their code, this isn't cleared when macro memory is rewritten as the same code will always compile into the same program
+
+        struct MacroSlot {
+            size_t offset; //!< The offset of the macro in macro memory that the program was compiled from
+            std::shared_ptr<MacroProgram> program;
+        };
+        std::array<MacroSlot, 0x80> slots{}; //!< The compiled program for each macro position
+        bool dirty{}; //!< If macro memory has been written to since the slots were last populated
+
+        /**
+         * @return The length of the macro starting at the supplied offset in words, this is determined by the exit instruction and any branches past it
+         */
+        static size_t GetMacroLength(span<u32> macroCode, size_t offset);
+
+        /**
+         * @brief Decodes the supplied macro code into a MacroProgram
+         */
+        static std::shared_ptr<MacroProgram> Compile(span<u32> code, size_t hash);
+
+      public:
+        /**
+         * @brief Invalidates all programs bound to macro positions, this must be called whenever macro memory is written to
+         */
+        void Invalidate() {
+            dirty = true;
+        }
+
+        /**
+         * @param index The index of the macro position
+         * @param offset The offset of the macro in macro memory
+         * @return The compiled program for the macro at the supplied offset, it will be compiled if it isn't in the cache already
+         */
+        MacroProgram &Get(size_t index, size_t offset, span<u32> macroCode);
+    };
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <soc/gm20b/engines/maxwell_3d.h>
+
+namespace skyline::soc::gm20b::engine::maxwell3d {
+    /**
+     * @brief An entry in the table of native macro implementations
+     */
+    struct MacroHleEntry {
+        size_t hash; //!< The hash of the macro's code as calculated by the MacroCompiler
+        MacroHleFunction function;
+    };
+
+    /**
+     * @brief All native macro implementations, entries should be added for macros which show up with high execution counts in the statistics logged by MacroHle
+     * @note This is empty as the most frequently executed macros are the instanced and indirect draw macros, they can't be implemented until the Maxwell 3D can issue draws
+     */
+    constexpr std::array<MacroHleEntry, 0> MacroHleTable{};
+
+    MacroHle::~MacroHle() {
+        if (statistics.empty())
+            return;
+
+        std::vector<std::pair<size_t, MacroStatistics>> macros(statistics.begin(), statistics.end());
+        std::sort(macros.begin(), macros.end(), [](const auto &a, const auto &b) {
+            return a.second.executions > b.second.executions;
+        });
+
+        for (const auto &[hash, macro] : macros)
+            state.logger->Info("Macro 0x{:016X} ({} words): {} executions, {} HLE ({}% hit rate)", hash, macro.size, macro.executions, macro.hleExecutions, (macro.hleExecutions * 100) / macro.executions);
+    }
+
+    MacroHleFunction MacroHle::Find(size_t hash) {
+        for (const auto &entry : MacroHleTable)
+            if (entry.hash == hash)
+                return entry.function;
+        return nullptr;
+    }
+
+    bool MacroHle::Execute(const MacroProgram &program, span<u32> args) {
+        auto &macro{statistics[program.hash]};
+        if (!macro.executions++) {
+            macro.size = program.code.size();
+            state.logger->Debug("First execution of macro 0x{:016X} ({} words){}", program.hash, macro.size, program.hle ? " with HLE" : "");
+        }
+
+        if (!program.hle)
+            return false;
+
+        program.hle(maxwell3D, args);
+        macro.hleExecutions++;
+        return true;
+    }
+}
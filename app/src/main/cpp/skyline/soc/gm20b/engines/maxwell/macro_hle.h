@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "macro_compiler.h"
+
+namespace skyline::soc::gm20b::engine::maxwell3d {
+    /**
+     * @brief The MacroHle class replaces execution of well-known macros with native implementations, macros are identified by the hash of their code
+     * @note Execution counts are tracked for every macro hash and logged when the engine is destroyed so that frequently executed macros can be added to the table
+     * @note The instanced and indirect draw macros can only be given native implementations once the Maxwell 3D can issue draws, until then only macros which solely write registers can be added
+     */
+    class MacroHle {
+      private:
+        const DeviceState &state;
+        Maxwell3D &maxwell3D;
+
+        struct MacroStatistics {
+            size_t size; //!< The size of the macro in words
+            u64 executions; //!< The amount of times the macro has been executed
+            u64 hleExecutions; //!< The amount of times the macro has been executed using a native implementation
+        };
+        std::unordered_map<size_t, MacroStatistics> statistics; //!< Statistics for every macro that has been executed, indexed by the hash of its code
+
+      public:
+        MacroHle(const DeviceState &state, Maxwell3D &maxwell3D) : state(state), maxwell3D(maxwell3D) {}
+
+        /**
+         * @brief Logs the execution statistics of all macros
+         */
+        ~MacroHle();
+
+        /**
+         * @return The native implementation of the macro with the supplied hash or nullptr if there isn't one
+         */
+        static MacroHleFunction Find(size_t hash);
+
+        /**
+         * @brief Executes the native implementation of the supplied program if it has one
+         * @return If the program was executed, another backend must be used to execute the program if this is false
+         */
+        bool Execute(const MacroProgram &program, span<u32> args);
+    };
+}
@@ -5,7 +5,7 @@
 #include <soc/gm20b/engines/maxwell_3d.h>
 
 namespace skyline::soc::gm20b::engine::maxwell3d {
-    void MacroInterpreter::Execute(size_t offset, const std::vector<u32> &args) {
+    void MacroInterpreter::Execute(size_t offset, span<u32> args) {
         // Reset the interpreter state
         registers = {};
         carryFlag = false;
@@ -19,6 +19,93 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
         while (Step());
     }
 
+    void MacroInterpreter::Execute(const MacroProgram &program, span<u32> args) {
+        // Reset the interpreter state
+        registers = {};
+        carryFlag = false;
+        methodAddress.raw = 0;
+        argument = args.data();
+
+        // The first argument is stored in register 1
+        registers[1] = *argument++;
+
+        u32 pc{}; // The index of the instruction that is currently being executed
+        u32 delayedPc{}; // The index of the instruction to jump to after the delay slot has been executed
+        bool inDelaySlot{}, exiting{};
+        while (true) {
+            if (pc >= program.instructions.size()) [[unlikely]]
+                throw exception("Macro execution went past the end of the program: 0x{:X}", pc);
+            const auto &instruction{program.instructions[pc]};
+
+            switch (instruction.operation) {
+                case Opcode::Operation::AluRegister:
+                    HandleAssignment(instruction.assignmentOperation, instruction.dest, HandleAlu(instruction.aluOperation, registers[instruction.srcA], registers[instruction.srcB]));
+                    break;
+
+                case Opcode::Operation::AddImmediate:
+                    HandleAssignment(instruction.assignmentOperation, instruction.dest, registers[instruction.srcA] + instruction.immediate);
+                    break;
+
+                case Opcode::Operation::BitfieldReplace: {
+                    u32 src{(registers[instruction.srcB] >> instruction.srcBit) & instruction.mask};
+                    u32 dest{registers[instruction.srcA] & ~(instruction.mask << instruction.destBit)};
+                    HandleAssignment(instruction.assignmentOperation, instruction.dest, dest | (src << instruction.destBit));
+                    break;
+                }
+
+                case Opcode::Operation::BitfieldExtractShiftLeftImmediate:
+                    HandleAssignment(instruction.assignmentOperation, instruction.dest, ((registers[instruction.srcB] >> registers[instruction.srcA]) & instruction.mask) << instruction.destBit);
+                    break;
+
+                case Opcode::Operation::BitfieldExtractShiftLeftRegister:
+                    HandleAssignment(instruction.assignmentOperation, instruction.dest, ((registers[instruction.srcB] >> instruction.srcBit) & instruction.mask) << registers[instruction.srcA]);
+                    break;
+
+                case Opcode::Operation::ReadImmediate:
+                    HandleAssignment(instruction.assignmentOperation, instruction.dest, maxwell3D.registers.raw[registers[instruction.srcA] + instruction.immediate]);
+                    break;
+
+                case Opcode::Operation::Branch: {
+                    if (inDelaySlot)
+                        throw exception("Cannot branch while inside a delay slot");
+
+                    u32 value{registers[instruction.srcA]};
+                    bool branch{(instruction.branchCondition == Opcode::BranchCondition::Zero) ? (value == 0) : (value != 0)};
+
+                    if (branch) {
+                        if (instruction.noDelay) {
+                            pc = static_cast<u32>(instruction.immediate);
+                        } else {
+                            // Step into delay slot
+                            delayedPc = static_cast<u32>(instruction.immediate);
+                            inDelaySlot = true;
+                            pc++;
+                        }
+                        continue;
+                    }
+                    break;
+                }
+
+                default:
+                    throw exception("Unknown MME opcode encountered: 0x{:X}", static_cast<u8>(instruction.operation));
+            }
+
+            if (inDelaySlot) {
+                if (exiting)
+                    return;
+
+                pc = delayedPc;
+                inDelaySlot = false;
+            } else if (instruction.exit) {
+                // Exit has a delay slot
+                exiting = inDelaySlot = true;
+                pc++;
+            } else {
+                pc++;
+            }
+        }
+    }
+
     FORCE_INLINE bool MacroInterpreter::Step(Opcode *delayedOpcode) {
         switch (opcode->operation) {
             case Opcode::Operation::AluRegister: {
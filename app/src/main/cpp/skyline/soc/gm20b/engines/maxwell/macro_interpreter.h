@@ -7,12 +7,13 @@
 
 namespace skyline::soc::gm20b::engine::maxwell3d {
     class Maxwell3D; // A forward declaration of Maxwell3D as we don't want to import it here
+    struct MacroProgram;
 
     /**
      * @brief The MacroInterpreter class handles interpreting macros. Macros are small programs that run on the GPU and are used for things like instanced rendering
      */
     class MacroInterpreter {
-      private:
+      public:
         #pragma pack(push, 1)
         union Opcode {
             u32 raw;
@@ -103,6 +104,7 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             };
         };
 
+      private:
         Maxwell3D &maxwell3D; //!< A reference to the parent engine object
 
         Opcode *opcode{}; //!< A pointer to the instruction that is currently being executed
@@ -142,7 +144,13 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
 
         /**
          * @brief Executes a GPU macro from macro memory with the given arguments
+         * @note This decodes every instruction as it is executed and serves as the reference implementation for the other macro backends
+         */
+        void Execute(size_t offset, span<u32> args);
+
+        /**
+         * @brief Executes a GPU macro that has been pre-decoded by the MacroCompiler with the given arguments
          */
-        void Execute(size_t offset, const std::vector<u32> &args);
+        void Execute(const MacroProgram &program, span<u32> args);
     };
 }
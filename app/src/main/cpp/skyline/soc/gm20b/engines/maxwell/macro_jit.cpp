@@ -0,0 +1,488 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <soc/gm20b/engines/maxwell_3d.h>
+
+namespace skyline::soc::gm20b::engine::maxwell3d {
+    /**
+     * @brief A minimal AArch64 assembler which emits the subset of instructions required to compile macros
+     * @note All general-purpose instructions operate on 32-bit W registers unless suffixed with X, register 31 is WZR for data-processing instructions and SP for loads/stores
+     * @url https://developer.arm.com/documentation/ddi0596/latest/Base-Instructions
+     */
+    class MacroAssembler {
+      public:
+        static constexpr u8 Zero{31}; //!< WZR or SP depending on the instruction
+
+        enum class Shift : u8 {
+            Lsl = 0,
+            Lsr = 1,
+        };
+
+        enum class Condition : u8 {
+            Eq = 0,
+            Ne = 1,
+            Cs = 2,
+            Cc = 3,
+        };
+
+        /**
+         * @brief The base encodings of 32-bit data-processing (shifted register) instructions
+         */
+        enum class Alu : u32 {
+            Add = 0x0B000000,
+            Adds = 0x2B000000,
+            Subs = 0x6B000000,
+            And = 0x0A000000,
+            Bic = 0x0A200000,
+            Orr = 0x2A000000,
+            Orn = 0x2A200000,
+            Eor = 0x4A000000,
+        };
+
+        /**
+         * @brief The base encodings of 32-bit data-processing instructions that take two registers without a shift
+         */
+        enum class AluCarry : u32 {
+            Adcs = 0x3A000000,
+            Sbcs = 0x7A000000,
+            Lslv = 0x1AC02000,
+            Lsrv = 0x1AC02400,
+        };
+
+      private:
+        /**
+         * @brief A branch to a label which needs to be resolved after all code has been emitted
+         */
+        struct Fixup {
+            size_t position; //!< The position of the branch instruction in the code
+            size_t label;
+            u8 offsetShift; //!< The bit offset of the branch immediate in the instruction
+            u8 offsetBits; //!< The amount of bits in the branch immediate
+        };
+
+        std::vector<size_t> labels; //!< The position of every label in the code, this is SIZE_MAX if it hasn't been bound yet
+        std::vector<Fixup> fixups;
+
+        void BranchTo(u32 instruction, size_t label, u8 offsetShift, u8 offsetBits) {
+            fixups.push_back(Fixup{code.size(), label, offsetShift, offsetBits});
+            code.push_back(instruction);
+        }
+
+      public:
+        std::vector<u32> code;
+
+        size_t CreateLabel() {
+            labels.push_back(std::numeric_limits<size_t>::max());
+            return labels.size() - 1;
+        }
+
+        void Bind(size_t label) {
+            labels[label] = code.size();
+        }
+
+        /**
+         * @brief Resolves the offsets of all branches to labels
+         * @return If all branches could be resolved, this will fail if a label is unbound or out of range of its branch
+         */
+        bool Resolve() {
+            for (const auto &fixup : fixups) {
+                if (labels[fixup.label] == std::numeric_limits<size_t>::max())
+                    return false;
+
+                i64 offset{static_cast<i64>(labels[fixup.label]) - static_cast<i64>(fixup.position)};
+                i64 limit{1L << (fixup.offsetBits - 1)};
+                if (offset < -limit || offset >= limit)
+                    return false;
+
+                code[fixup.position] |= (static_cast<u32>(offset) & ((1U << fixup.offsetBits) - 1)) << fixup.offsetShift;
+            }
+            return true;
+        }
+
+        void AluShifted(Alu operation, u8 rd, u8 rn, u8 rm, Shift shift = Shift::Lsl, u8 amount = 0) {
+            code.push_back(static_cast<u32>(operation) | (static_cast<u32>(shift) << 22) | (static_cast<u32>(rm) << 16) | (static_cast<u32>(amount & 0x1F) << 10) | (static_cast<u32>(rn) << 5) | rd);
+        }
+
+        void AluRegister(AluCarry operation, u8 rd, u8 rn, u8 rm) {
+            code.push_back(static_cast<u32>(operation) | (static_cast<u32>(rm) << 16) | (static_cast<u32>(rn) << 5) | rd);
+        }
+
+        void Mov(u8 rd, u8 rm) {
+            AluShifted(Alu::Orr, rd, Zero, rm);
+        }
+
+        void MovX(u8 rd, u8 rm) {
+            code.push_back(0xAA0003E0 | (static_cast<u32>(rm) << 16) | rd);
+        }
+
+        /**
+         * @brief Moves the stack pointer into a 64-bit register using ADD (immediate) as ORR cannot encode SP
+         */
+        void MovFromSpX(u8 rd) {
+            code.push_back(0x91000000 | (static_cast<u32>(Zero) << 5) | rd);
+        }
+
+        void MoveImmediate(u8 rd, u32 value) {
+            code.push_back(0x52800000 | ((value & 0xFFFF) << 5) | rd); // MOVZ
+            if (value >> 16)
+                code.push_back(0x72800000 | (1U << 21) | ((value >> 16) << 5) | rd); // MOVK (LSL #16)
+        }
+
+        /**
+         * @brief Sets the destination register to 1 if the condition holds or 0 otherwise using CSINC with the inverted condition
+         */
+        void Cset(u8 rd, Condition condition) {
+            code.push_back(0x1A800400 | (static_cast<u32>(Zero) << 16) | (static_cast<u32>(static_cast<u8>(condition) ^ 1) << 12) | (static_cast<u32>(Zero) << 5) | rd);
+        }
+
+        void CmpImmediate(u8 rn, u16 immediate) {
+            code.push_back(0x71000000 | (static_cast<u32>(immediate & 0xFFF) << 10) | (static_cast<u32>(rn) << 5) | Zero); // SUBS WZR
+        }
+
+        void Ubfx(u8 rd, u8 rn, u8 lsb, u8 width) {
+            code.push_back(0x53000000 | (static_cast<u32>(lsb) << 16) | (static_cast<u32>(lsb + width - 1) << 10) | (static_cast<u32>(rn) << 5) | rd);
+        }
+
+        /**
+         * @brief Loads a word from the address in the base register and then increments it by the size of a word
+         */
+        void LdrPostIndex(u8 rt, u8 rn) {
+            code.push_back(0xB8400400 | (static_cast<u32>(sizeof(u32)) << 12) | (static_cast<u32>(rn) << 5) | rt);
+        }
+
+        /**
+         * @brief Loads a word from the word array at the base register with the index register zero-extended
+         */
+        void LdrIndexed(u8 rt, u8 rn, u8 rm) {
+            code.push_back(0xB8605800 | (static_cast<u32>(rm) << 16) | (static_cast<u32>(rn) << 5) | rt);
+        }
+
+        void LdrX(u8 rt, u8 rn, u16 offset) {
+            code.push_back(0xF9400000 | (static_cast<u32>(offset / sizeof(u64)) << 10) | (static_cast<u32>(rn) << 5) | rt);
+        }
+
+        void StrX(u8 rt, u8 rn, u16 offset) {
+            code.push_back(0xF9000000 | (static_cast<u32>(offset / sizeof(u64)) << 10) | (static_cast<u32>(rn) << 5) | rt);
+        }
+
+        void StpX(u8 rt1, u8 rt2, u8 rn, i16 offset, bool preIndex = false) {
+            code.push_back((preIndex ? 0xA9800000 : 0xA9000000) | ((static_cast<u32>(offset / static_cast<i16>(sizeof(u64))) & 0x7F) << 15) | (static_cast<u32>(rt2) << 10) | (static_cast<u32>(rn) << 5) | rt1);
+        }
+
+        void LdpX(u8 rt1, u8 rt2, u8 rn, i16 offset, bool postIndex = false) {
+            code.push_back((postIndex ? 0xA8C00000 : 0xA9400000) | ((static_cast<u32>(offset / static_cast<i16>(sizeof(u64))) & 0x7F) << 15) | (static_cast<u32>(rt2) << 10) | (static_cast<u32>(rn) << 5) | rt1);
+        }
+
+        void Blr(u8 rn) {
+            code.push_back(0xD63F0000 | (static_cast<u32>(rn) << 5));
+        }
+
+        void Ret() {
+            code.push_back(0xD65F03C0);
+        }
+
+        void B(size_t label) {
+            BranchTo(0x14000000, label, 0, 26);
+        }
+
+        /**
+         * @brief Branches to the label if the register is zero (CBZ) or non-zero (CBNZ)
+         */
+        void Cbz(bool nonZero, u8 rt, size_t label) {
+            BranchTo((nonZero ? 0x35000000 : 0x34000000) | rt, label, 5, 19);
+        }
+
+        /**
+         * @brief Branches to the label if the specified bit of the 64-bit register is set
+         */
+        void TbnzX(u8 rt, u8 bit, size_t label) {
+            BranchTo(0x37000000 | (static_cast<u32>(bit >> 5) << 31) | (static_cast<u32>(bit & 0x1F) << 19) | rt, label, 5, 14);
+        }
+    };
+
+    constexpr u8 ArgumentRegister{0}, MethodAddressArgumentRegister{1}, SendArgumentRegister{2}; //!< The registers used for arguments in calls to MacroJit::Send
+    constexpr u8 ResultRegister{9}, ScratchRegister0{10}, ScratchRegister1{11}; //!< Caller-saved registers for temporary values
+    constexpr u8 CallRegister{16};
+    constexpr u8 CarryRegister{26}, MethodAddressRegister{27}, ArgumentPointerRegister{28};
+    constexpr u8 FramePointer{29}, LinkRegister{30};
+
+    constexpr i16 FrameSize{0x80}; //!< The size of the stack frame, this holds all callee-saved registers and the local slots below
+    constexpr u16 RegistersSlot{0x60}, JitSlot{0x68}, SendSlot{0x70}; //!< Offsets of the function arguments spilled onto the stack frame
+
+    /**
+     * @return The host register that an MME register is allocated to, register 0 is hardwired to zero
+     */
+    constexpr u8 HostRegister(u8 reg) {
+        return reg ? static_cast<u8>(18 + reg) : MacroAssembler::Zero;
+    }
+
+    MacroJitCode::MacroJitCode(span<u32> code) : size(util::AlignUp(code.size_bytes(), PAGE_SIZE)) {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (memory == MAP_FAILED)
+            throw exception("Failed to allocate memory for macro host code: {}", strerror(errno));
+
+        std::memcpy(memory, code.data(), code.size_bytes());
+        if (mprotect(memory, size, PROT_READ | PROT_EXEC) < 0)
+            throw exception("Failed to reprotect macro host code: {}", strerror(errno));
+        __builtin___clear_cache(reinterpret_cast<char *>(memory), reinterpret_cast<char *>(memory) + code.size_bytes());
+
+        function = reinterpret_cast<MacroJitFunction>(memory);
+    }
+
+    MacroJitCode::~MacroJitCode() {
+        munmap(memory, size);
+    }
+
+    u64 MacroJit::Send(MacroJit *jit, u32 methodAddressRaw, u32 argument) {
+        MacroInterpreter::MethodAddress methodAddress{.raw = methodAddressRaw};
+        try {
+            jit->maxwell3D.CallMethod(MethodParams{methodAddress.address, argument, 0, true});
+        } catch (...) {
+            jit->pendingException = std::current_exception();
+            return 1UL << 32;
+        }
+
+        methodAddress.address += methodAddress.increment;
+        return methodAddress.raw;
+    }
+
+    std::shared_ptr<MacroJitCode> MacroJit::Compile(const MacroProgram &program) {
+        using Opcode = MacroInterpreter::Opcode;
+        using Alu = MacroAssembler::Alu;
+        using AluCarry = MacroAssembler::AluCarry;
+        using Shift = MacroAssembler::Shift;
+        using Condition = MacroAssembler::Condition;
+        constexpr u8 Zero{MacroAssembler::Zero};
+
+        const auto &instructions{program.instructions};
+        MacroAssembler assembler;
+
+        std::vector<size_t> labels(instructions.size());
+        for (auto &label : labels)
+            label = assembler.CreateLabel();
+        size_t exitLabel{assembler.CreateLabel()};
+
+        auto send{[&](u8 argumentRegister) {
+            assembler.Mov(SendArgumentRegister, argumentRegister);
+            assembler.Mov(MethodAddressArgumentRegister, MethodAddressRegister);
+            assembler.LdrX(ArgumentRegister, Zero, JitSlot);
+            assembler.LdrX(CallRegister, Zero, SendSlot);
+            assembler.Blr(CallRegister);
+            assembler.TbnzX(ArgumentRegister, 32, exitLabel);
+            assembler.Mov(MethodAddressRegister, ArgumentRegister);
+        }};
+
+        // Emits the code for a non-branch instruction with its result in ResultRegister followed by its assignment operation
+        auto emitOperation{[&](const MacroInstruction &instruction) {
+            u8 srcA{HostRegister(instruction.srcA)}, srcB{HostRegister(instruction.srcB)};
+            switch (instruction.operation) {
+                case Opcode::Operation::AluRegister:
+                    switch (instruction.aluOperation) {
+                        case Opcode::AluOperation::Add:
+                            assembler.AluShifted(Alu::Adds, ResultRegister, srcA, srcB);
+                            assembler.Cset(CarryRegister, Condition::Cs);
+                            break;
+                        case Opcode::AluOperation::AddWithCarry:
+                            assembler.CmpImmediate(CarryRegister, 1); // Transfer the carry flag into PSTATE.C
+                            assembler.AluRegister(AluCarry::Adcs, ResultRegister, srcA, srcB);
+                            assembler.Cset(CarryRegister, Condition::Cs);
+                            break;
+                        case Opcode::AluOperation::Subtract:
+                            assembler.AluShifted(Alu::Subs, ResultRegister, srcA, srcB);
+                            assembler.Cset(CarryRegister, Condition::Ne); // The interpreter sets the carry flag when the result is non-zero
+                            break;
+                        case Opcode::AluOperation::SubtractWithBorrow:
+                            assembler.CmpImmediate(CarryRegister, 1);
+                            assembler.AluRegister(AluCarry::Sbcs, ResultRegister, srcA, srcB);
+                            assembler.Cset(CarryRegister, Condition::Ne);
+                            break;
+                        case Opcode::AluOperation::BitwiseXor:
+                            assembler.AluShifted(Alu::Eor, ResultRegister, srcA, srcB);
+                            break;
+                        case Opcode::AluOperation::BitwiseOr:
+                            assembler.AluShifted(Alu::Orr, ResultRegister, srcA, srcB);
+                            break;
+                        case Opcode::AluOperation::BitwiseAnd:
+                            assembler.AluShifted(Alu::And, ResultRegister, srcA, srcB);
+                            break;
+                        case Opcode::AluOperation::BitwiseAndNot:
+                            assembler.AluShifted(Alu::Bic, ResultRegister, srcA, srcB);
+                            break;
+                        case Opcode::AluOperation::BitwiseNand:
+                            assembler.AluShifted(Alu::And, ResultRegister, srcA, srcB);
+                            assembler.AluShifted(Alu::Orn, ResultRegister, Zero, ResultRegister);
+                            break;
+                        default:
+                            return false;
+                    }
+                    break;
+
+                case Opcode::Operation::AddImmediate:
+                    assembler.MoveImmediate(ScratchRegister0, static_cast<u32>(instruction.immediate));
+                    assembler.AluShifted(Alu::Add, ResultRegister, srcA, ScratchRegister0);
+                    break;
+
+                case Opcode::Operation::BitfieldReplace:
+                    assembler.MoveImmediate(ScratchRegister0, instruction.mask);
+                    assembler.AluShifted(Alu::And, ScratchRegister0, ScratchRegister0, srcB, Shift::Lsr, instruction.srcBit);
+                    assembler.MoveImmediate(ScratchRegister1, instruction.mask << instruction.destBit);
+                    assembler.AluShifted(Alu::Bic, ResultRegister, srcA, ScratchRegister1);
+                    assembler.AluShifted(Alu::Orr, ResultRegister, ResultRegister, ScratchRegister0, Shift::Lsl, instruction.destBit);
+                    break;
+
+                case Opcode::Operation::BitfieldExtractShiftLeftImmediate:
+                    assembler.AluRegister(AluCarry::Lsrv, ScratchRegister0, srcB, srcA);
+                    assembler.MoveImmediate(ScratchRegister1, instruction.mask);
+                    assembler.AluShifted(Alu::And, ScratchRegister0, ScratchRegister0, ScratchRegister1);
+                    assembler.AluShifted(Alu::Orr, ResultRegister, Zero, ScratchRegister0, Shift::Lsl, instruction.destBit);
+                    break;
+
+                case Opcode::Operation::BitfieldExtractShiftLeftRegister:
+                    assembler.MoveImmediate(ScratchRegister1, instruction.mask);
+                    assembler.AluShifted(Alu::And, ScratchRegister0, ScratchRegister1, srcB, Shift::Lsr, instruction.srcBit);
+                    assembler.AluRegister(AluCarry::Lslv, ResultRegister, ScratchRegister0, srcA);
+                    break;
+
+                case Opcode::Operation::ReadImmediate:
+                    assembler.MoveImmediate(ScratchRegister0, static_cast<u32>(instruction.immediate));
+                    assembler.AluShifted(Alu::Add, ScratchRegister0, srcA, ScratchRegister0);
+                    assembler.LdrX(ScratchRegister1, Zero, RegistersSlot);
+                    assembler.LdrIndexed(ResultRegister, ScratchRegister1, ScratchRegister0);
+                    break;
+
+                default:
+                    return false;
+            }
+
+            u8 dest{HostRegister(instruction.dest)}; // Writes to register 0 are discarded by WZR
+            switch (instruction.assignmentOperation) {
+                case Opcode::AssignmentOperation::IgnoreAndFetch:
+                    assembler.LdrPostIndex(dest, ArgumentPointerRegister);
+                    break;
+                case Opcode::AssignmentOperation::Move:
+                    assembler.Mov(dest, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethod:
+                    assembler.Mov(dest, ResultRegister);
+                    assembler.Mov(MethodAddressRegister, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::FetchAndSend:
+                    assembler.LdrPostIndex(dest, ArgumentPointerRegister);
+                    send(ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSend:
+                    assembler.Mov(dest, ResultRegister);
+                    send(ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::FetchAndSetMethod:
+                    assembler.LdrPostIndex(dest, ArgumentPointerRegister);
+                    assembler.Mov(MethodAddressRegister, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethodThenFetchAndSend:
+                    assembler.Mov(dest, ResultRegister);
+                    assembler.Mov(MethodAddressRegister, ResultRegister);
+                    assembler.LdrPostIndex(ScratchRegister0, ArgumentPointerRegister);
+                    send(ScratchRegister0);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethodThenSendHigh:
+                    assembler.Mov(dest, ResultRegister);
+                    assembler.Mov(MethodAddressRegister, ResultRegister);
+                    assembler.Ubfx(ScratchRegister0, ResultRegister, 12, 6); // MethodAddress::increment
+                    send(ScratchRegister0);
+                    break;
+            }
+            return true;
+        }};
+
+        // Prologue: Save all callee-saved registers that we use and spill the arguments onto the stack
+        assembler.StpX(FramePointer, LinkRegister, Zero, -FrameSize, true);
+        assembler.MovFromSpX(FramePointer);
+        for (u8 reg{19}; reg <= 27; reg += 2)
+            assembler.StpX(reg, reg + 1, Zero, static_cast<i16>((reg - 17) * sizeof(u64)));
+        assembler.StrX(1, Zero, RegistersSlot);
+        assembler.StrX(2, Zero, JitSlot);
+        assembler.StrX(3, Zero, SendSlot);
+        assembler.MovX(ArgumentPointerRegister, 0);
+        for (u8 reg{HostRegister(1)}; reg <= MethodAddressRegister; reg++)
+            assembler.Mov(reg, Zero);
+        assembler.LdrPostIndex(HostRegister(1), ArgumentPointerRegister); // The first argument is stored in register 1
+
+        struct DelaySlot {
+            size_t label;
+            size_t index; //!< The index of the branch instruction that the delay slot belongs to
+        };
+        std::vector<DelaySlot> delaySlots;
+
+        // The instruction after the supplied index must be a non-branch instruction to be executed as a delay slot
+        auto hasDelaySlot{[&](size_t index) {
+            return index + 1 < instructions.size() && instructions[index + 1].operation != Opcode::Operation::Branch;
+        }};
+
+        for (size_t index{}; index < instructions.size(); index++) {
+            const auto &instruction{instructions[index]};
+            assembler.Bind(labels[index]);
+
+            if (instruction.operation == Opcode::Operation::Branch) {
+                if (instruction.immediate < 0 || static_cast<size_t>(instruction.immediate) >= instructions.size())
+                    return nullptr;
+
+                bool nonZero{instruction.branchCondition == Opcode::BranchCondition::NonZero};
+                if (instruction.noDelay) {
+                    assembler.Cbz(nonZero, HostRegister(instruction.srcA), labels[static_cast<size_t>(instruction.immediate)]);
+                } else {
+                    if (!hasDelaySlot(index))
+                        return nullptr;
+
+                    size_t label{assembler.CreateLabel()};
+                    delaySlots.push_back(DelaySlot{label, index});
+                    assembler.Cbz(nonZero, HostRegister(instruction.srcA), label);
+                }
+            } else if (!emitOperation(instruction)) {
+                return nullptr;
+            }
+
+            if (instruction.exit) {
+                // Exit has a delay slot
+                if (!hasDelaySlot(index) || !emitOperation(instructions[index + 1]))
+                    return nullptr;
+                assembler.B(exitLabel);
+            }
+        }
+
+        // Epilogue: Restore all callee-saved registers and return
+        assembler.Bind(exitLabel);
+        for (u8 reg{19}; reg <= 27; reg += 2)
+            assembler.LdpX(reg, reg + 1, Zero, static_cast<i16>((reg - 17) * sizeof(u64)));
+        assembler.LdpX(FramePointer, LinkRegister, Zero, FrameSize, true);
+        assembler.Ret();
+
+        // Branches with a delay slot execute the instruction following them before jumping to their target, this is done out-of-line
+        for (const auto &delaySlot : delaySlots) {
+            assembler.Bind(delaySlot.label);
+            if (!emitOperation(instructions[delaySlot.index + 1]))
+                return nullptr;
+            assembler.B(labels[static_cast<size_t>(instructions[delaySlot.index].immediate)]);
+        }
+
+        if (!assembler.Resolve())
+            return nullptr;
+
+        return std::make_shared<MacroJitCode>(assembler.code);
+    }
+
+    bool MacroJit::Execute(MacroProgram &program, span<u32> args) {
+        if (!program.nativeAttempted) {
+            program.native = Compile(program);
+            program.nativeAttempted = true;
+        }
+
+        if (!program.native)
+            return false;
+
+        program.native->function(args.data(), maxwell3D.registers.raw.data(), this, &MacroJit::Send);
+
+        if (pendingException)
+            std::rethrow_exception(std::exchange(pendingException, nullptr));
+        return true;
+    }
+}
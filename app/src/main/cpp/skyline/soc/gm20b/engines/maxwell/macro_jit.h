@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "macro_compiler.h"
+
+namespace skyline::soc::gm20b::engine::maxwell3d {
+    class MacroJit;
+
+    /**
+     * @brief A function which sends a method call to the Maxwell 3D with the supplied method address
+     * @return The updated method address in the lower 32 bits, bit 32 is set if the macro needs to be aborted due to an exception
+     */
+    using MacroSendFunction = u64 (*)(MacroJit *jit, u32 methodAddress, u32 argument);
+
+    /**
+     * @brief The entry point of a macro compiled into host code
+     * @param arguments The argument buffer for the macro, it is read from sequentially
+     * @param registers A pointer to the raw Maxwell 3D registers which are read from by the macro
+     */
+    using MacroJitFunction = void (*)(const u32 *arguments, u32 *registers, MacroJit *jit, MacroSendFunction send);
+
+    /**
+     * @brief A block of executable memory containing the host code for a single macro
+     */
+    struct MacroJitCode {
+        void *memory;
+        size_t size;
+        MacroJitFunction function;
+
+        MacroJitCode(span<u32> code);
+
+        MacroJitCode(const MacroJitCode &) = delete;
+
+        ~MacroJitCode();
+    };
+
+    /**
+     * @brief The MacroJit class compiles pre-decoded macro programs into AArch64 host code, any program which cannot be compiled will fall back to the MacroInterpreter
+     * @note MME registers 1-7 are statically allocated to W19-W25 while the carry flag, method address and argument pointer are held in W26, W27 and X28 respectively
+     */
+    class MacroJit {
+      private:
+        Maxwell3D &maxwell3D;
+        std::exception_ptr pendingException; //!< An exception thrown while sending a method call from host code, it's rethrown after the macro has been aborted as it cannot be unwound through host code
+
+        /**
+         * @brief Sends a method call to the Maxwell 3D, this is called directly from host code
+         */
+        static u64 Send(MacroJit *jit, u32 methodAddress, u32 argument);
+
+        /**
+         * @return The host code for the supplied program or nullptr if it contains any constructs which cannot be compiled
+         */
+        static std::shared_ptr<MacroJitCode> Compile(const MacroProgram &program);
+
+      public:
+        MacroJit(Maxwell3D &maxwell3D) : maxwell3D(maxwell3D) {}
+
+        /**
+         * @brief Executes the supplied program as host code if possible
+         * @return If the program was executed, the MacroInterpreter must be used instead if this is false
+         */
+        bool Execute(MacroProgram &program, span<u32> args);
+    };
+}
@@ -4,7 +4,75 @@
 #include <soc.h>
 
 namespace skyline::soc::gm20b::engine::maxwell3d {
-    Maxwell3D::Maxwell3D(const DeviceState &state) : Engine(state), macroInterpreter(*this) {
+    /**
+     * @brief A table of the dirty state group of every register, this is looked up on every register write
+     */
+    constexpr std::array<Maxwell3D::DirtyState, Maxwell3D::RegisterCount> DirtyStateTable{[] {
+        using Registers = Maxwell3D::Registers;
+        using DirtyState = Maxwell3D::DirtyState;
+
+        std::array<DirtyState, Maxwell3D::RegisterCount> table{};
+        table.fill(DirtyState::None);
+
+        auto setGroup{[&table](size_t offset, size_t size, DirtyState dirtyState) {
+            for (size_t index{offset}; index < offset + (size / sizeof(u32)); index++)
+                table[index] = dirtyState;
+        }};
+
+        #define DIRTY_STATE(field, dirtyState) setGroup(MAXWELL3D_OFFSET(field), sizeof(Registers::field), DirtyState::dirtyState)
+
+        DIRTY_STATE(rtSeparateFragData, RenderTargets);
+        DIRTY_STATE(colorMask, RenderTargets);
+
+        DIRTY_STATE(viewportTransform, Viewport);
+        DIRTY_STATE(viewport, Viewport);
+        DIRTY_STATE(viewportTransformEnable, Viewport);
+
+        DIRTY_STATE(rasterizerEnable, Rasterizer);
+        DIRTY_STATE(polygonMode, Rasterizer);
+        DIRTY_STATE(lineWidthSmooth, Rasterizer);
+        DIRTY_STATE(lineWidthAliased, Rasterizer);
+        DIRTY_STATE(lineSmoothEnable, Rasterizer);
+        DIRTY_STATE(clipDistanceEnable, Rasterizer);
+        DIRTY_STATE(pointSpriteSize, Rasterizer);
+        DIRTY_STATE(pointSpriteEnable, Rasterizer);
+        DIRTY_STATE(pointCoordReplace, Rasterizer);
+        DIRTY_STATE(polygonOffsetFactor, Rasterizer);
+        DIRTY_STATE(cullFaceEnable, Rasterizer);
+        DIRTY_STATE(frontFace, Rasterizer);
+        DIRTY_STATE(cullFace, Rasterizer);
+
+        DIRTY_STATE(blendConstant, Blend);
+        DIRTY_STATE(blend, Blend);
+        DIRTY_STATE(independentBlend, Blend);
+
+        DIRTY_STATE(depthTestFunc, DepthStencil);
+        DIRTY_STATE(depthTargetEnable, DepthStencil);
+        DIRTY_STATE(alphaTestRef, DepthStencil);
+        DIRTY_STATE(alphaTestFunc, DepthStencil);
+        DIRTY_STATE(stencilEnable, DepthStencil);
+        DIRTY_STATE(stencilFront, DepthStencil);
+        DIRTY_STATE(stencilTwoSideEnable, DepthStencil);
+        DIRTY_STATE(stencilBack, DepthStencil);
+        DIRTY_STATE(stencilBackExtra, DepthStencil);
+
+        DIRTY_STATE(multisampleEnable, Multisample);
+        DIRTY_STATE(multisampleControl, Multisample);
+
+        DIRTY_STATE(vertexAttributeState, VertexAttributes);
+
+        DIRTY_STATE(texSamplerPool, TexturePools);
+        DIRTY_STATE(texHeaderPool, TexturePools);
+
+        DIRTY_STATE(drawBaseVertex, Draw);
+        DIRTY_STATE(drawBaseInstance, Draw);
+
+        #undef DIRTY_STATE
+
+        return table;
+    }()};
+
+    Maxwell3D::Maxwell3D(const DeviceState &state) : Engine(state), macroInterpreter(*this), macroJit(*this), macroHle(state, *this) {
         ResetRegs();
     }
 
@@ -70,6 +138,8 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
         }
 
         registers.viewportTransformEnable = true;
+
+        dirtyStates.set();
     }
 
     void Maxwell3D::CallMethod(MethodParams params) {
@@ -80,19 +150,40 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             if (!(params.method & 1))
                 macroInvocation.index = ((params.method - RegisterCount) >> 1) % macroPositions.size();
 
-            macroInvocation.arguments.push_back(params.argument);
+            auto &arguments{macroInvocation.arguments};
+            if (!macroInvocation.buffered && params.argumentPointer && (arguments.empty() || params.argumentPointer == arguments.data() + arguments.size())) {
+                // The arguments are read directly from the pushbuffer while they're contiguous
+                arguments = span<u32>(arguments.empty() ? params.argumentPointer : arguments.data(), arguments.size() + 1);
+            } else {
+                if (!macroInvocation.buffered) {
+                    macroInvocation.argumentBuffer.assign(arguments.begin(), arguments.end());
+                    macroInvocation.buffered = true;
+                }
+                macroInvocation.argumentBuffer.push_back(params.argument);
+            }
 
             // Macros are always executed on the last method call in a pushbuffer entry
             if (params.lastCall) {
-                macroInterpreter.Execute(macroPositions[macroInvocation.index], macroInvocation.arguments);
+                span<u32> args{macroInvocation.buffered ? span<u32>(macroInvocation.argumentBuffer) : arguments};
 
-                macroInvocation.arguments.clear();
+                auto &program{macroCompiler.Get(macroInvocation.index, macroPositions[macroInvocation.index], macroCode)};
+                if (!macroHle.Execute(program, args) && !macroJit.Execute(program, args))
+                    macroInterpreter.Execute(program, args);
+
+                arguments = span<u32>{};
+                macroInvocation.argumentBuffer.clear();
+                macroInvocation.buffered = false;
                 macroInvocation.index = 0;
             }
             return;
         }
 
-        registers.raw[params.method] = params.argument;
+        // Writes which don't change the value of a register don't dirty its group
+        if (registers.raw[params.method] != params.argument) {
+            registers.raw[params.method] = params.argument;
+            if (auto dirtyState{DirtyStateTable[params.method]}; dirtyState != DirtyState::None)
+                dirtyStates.set(static_cast<size_t>(dirtyState));
+        }
 
         if (shadowRegisters.mme.shadowRamControl == Registers::MmeShadowRamControl::MethodTrack || shadowRegisters.mme.shadowRamControl == Registers::MmeShadowRamControl::MethodTrackWithFilter)
             shadowRegisters.raw[params.method] = params.argument;
@@ -105,6 +196,7 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
                     throw exception("Macro memory is full!");
 
                 macroCode[registers.mme.instructionRamPointer++] = params.argument;
+                macroCompiler.Invalidate();
                 break;
             case MAXWELL3D_OFFSET(mme.startAddressRamLoad):
                 if (registers.mme.startAddressRamPointer >= macroPositions.size())
@@ -4,7 +4,8 @@
 #pragma once
 
 #include "engine.h"
-#include "maxwell/macro_interpreter.h"
+#include "maxwell/macro_jit.h"
+#include "maxwell/macro_hle.h"
 
 #define MAXWELL3D_OFFSET(field) U32_OFFSET(Registers, field)
 
@@ -18,10 +19,15 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
 
         struct {
             u32 index;
-            std::vector<u32> arguments;
+            span<u32> arguments; //!< The arguments of the macro inside the pushbuffer, this is used while they're contiguous to avoid copying them
+            std::vector<u32> argumentBuffer; //!< A buffer for arguments which aren't contiguous in the pushbuffer, it is persistent to avoid constant reallocations
+            bool buffered; //!< If the arguments are in the argument buffer rather than the pushbuffer
         } macroInvocation{}; //!< Data for a macro that is pending execution
 
         MacroInterpreter macroInterpreter;
+        MacroCompiler macroCompiler;
+        MacroJit macroJit;
+        MacroHle macroHle;
 
         void HandleSemaphoreCounterOperation();
 
@@ -30,6 +36,23 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
       public:
         static constexpr u32 RegisterCount{0xE00}; //!< The number of Maxwell 3D registers
 
+        /**
+         * @brief Groups of registers which are tracked for modifications so that only state which has changed needs to be translated
+         */
+        enum class DirtyState : u8 {
+            RenderTargets, //!< Per-render target state such as the color write masks
+            Viewport, //!< The viewports and their transforms
+            Rasterizer, //!< Polygon modes, culling, line widths and point sprites
+            Blend, //!< The blend constant and common or independent blend state
+            DepthStencil, //!< Depth testing, stencil testing and alpha testing
+            Multisample, //!< Multisampling enable and control
+            VertexAttributes, //!< The state of every vertex attribute
+            TexturePools, //!< The texture sampler and header pools
+            Draw, //!< The base vertex and instance of draws
+            Count, //!< The amount of dirty states, this isn't a valid state
+            None = 0xFF, //!< Registers that aren't part of any group and don't need to be tracked
+        };
+
         /**
          * @url https://github.com/devkitPro/deko3d/blob/master/source/maxwell/engine_3d.def#L478
          */
@@ -556,6 +579,7 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
 
         Registers registers{};
         Registers shadowRegisters{}; //!< The shadow registers, their function is controlled by the 'shadowRamControl' register
+        std::bitset<static_cast<size_t>(DirtyState::Count)> dirtyStates; //!< A bitset of groups with registers which have been modified since they were last consumed
 
         std::array<u32, 0x10000> macroCode{}; //!< This stores GPU macros, the 256KiB size is from Ryujinx
 
@@ -566,6 +590,16 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
          */
         void ResetRegs();
 
+        /**
+         * @return If any register in the supplied group has changed since it was last consumed, this clears the dirty state of the group
+         */
+        bool ConsumeDirtyState(DirtyState dirtyState) {
+            auto index{static_cast<size_t>(dirtyState)};
+            bool dirty{dirtyStates.test(index)};
+            dirtyStates.reset(index);
+            return dirty;
+        }
+
         void CallMethod(MethodParams params) override;
     };
 }
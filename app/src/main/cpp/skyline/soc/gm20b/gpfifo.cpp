@@ -67,17 +67,17 @@ namespace skyline::soc::gm20b {
             switch (methodHeader.secOp) {
                 case PushBufferMethodHeader::SecOp::IncMethod:
                     for (u16 i{}; i < methodHeader.methodCount; i++)
-                        Send(MethodParams{static_cast<u16>(methodHeader.methodAddress + i), *++entry, methodHeader.methodSubChannel, i == methodHeader.methodCount - 1});
+                        Send(MethodParams{static_cast<u16>(methodHeader.methodAddress + i), *++entry, methodHeader.methodSubChannel, i == methodHeader.methodCount - 1, &*entry});
                     break;
 
                 case PushBufferMethodHeader::SecOp::NonIncMethod:
                     for (u16 i{}; i < methodHeader.methodCount; i++)
-                        Send(MethodParams{methodHeader.methodAddress, *++entry, methodHeader.methodSubChannel, i == methodHeader.methodCount - 1});
+                        Send(MethodParams{methodHeader.methodAddress, *++entry, methodHeader.methodSubChannel, i == methodHeader.methodCount - 1, &*entry});
                     break;
 
                 case PushBufferMethodHeader::SecOp::OneInc:
                     for (u16 i{}; i < methodHeader.methodCount; i++)
-                        Send(MethodParams{static_cast<u16>(methodHeader.methodAddress + static_cast<bool>(i)), *++entry, methodHeader.methodSubChannel, i == methodHeader.methodCount - 1});
+                        Send(MethodParams{static_cast<u16>(methodHeader.methodAddress + static_cast<bool>(i)), *++entry, methodHeader.methodSubChannel, i == methodHeader.methodCount - 1, &*entry});
                     break;
 
                 case PushBufferMethodHeader::SecOp::ImmdDataMethod:
@@ -10,9 +10,27 @@ namespace skyline::vfs {
      * @brief The Backing class provides abstract access to a storage device, all access can be done without using a specific backing
      */
     class Backing {
+      public:
+        /**
+         * @brief A single read in a batch of reads
+         */
+        struct ReadRequest {
+            span<u8> output; //!< The buffer to read into
+            size_t offset; //!< The offset to start reading from
+            size_t read{}; //!< The amount of bytes read, this is set once the batch has completed
+        };
+
       protected:
         virtual size_t ReadImpl(span <u8> output, size_t offset) = 0;
 
+        /**
+         * @brief Performs all reads in a batch, backings which can perform multiple reads concurrently should override this
+         */
+        virtual void ReadBatchImpl(span<ReadRequest> requests) {
+            for (auto &request : requests)
+                request.read = ReadImpl(request.output, request.offset);
+        }
+
         virtual size_t WriteImpl(span <u8> input, size_t offset) {
             throw exception("This backing does not support being written to");
         }
@@ -60,6 +78,17 @@ namespace skyline::vfs {
             return ReadImpl(output, offset);
         };
 
+        /**
+         * @brief Performs multiple reads from the backing, these may be done concurrently and complete in any order
+         * @note The amount of bytes read by each request is written into ReadRequest::read, it isn't checked against the size of the output
+         */
+        void ReadBatch(span<ReadRequest> requests) {
+            if (!mode.read)
+                throw exception("Attempting to read a backing that is not readable");
+
+            ReadBatchImpl(requests);
+        }
+
         /**
          * @brief Read bytes from the backing at a particular offset to a buffer and check to ensure the full size was read
          * @param output The object to write the data read to
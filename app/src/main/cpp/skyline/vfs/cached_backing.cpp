@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "cached_backing.h"
+
+namespace skyline::vfs {
+    bool BlockCache::Read(u64 backingId, size_t block, span<u8> output, size_t offset) {
+        std::scoped_lock lock(mutex);
+        auto entry{entryMap.find(Key{backingId, block})};
+        if (entry == entryMap.end() || entry->second->data.size() <= offset) {
+            statistics.misses++;
+            return false;
+        }
+
+        entries.splice(entries.begin(), entries, entry->second);
+        auto &data{entry->second->data};
+        std::memcpy(output.data(), data.data() + offset, std::min(output.size(), data.size() - offset));
+        statistics.hits++;
+        return true;
+    }
+
+    bool BlockCache::Contains(u64 backingId, size_t block) {
+        std::scoped_lock lock(mutex);
+        return entryMap.contains(Key{backingId, block});
+    }
+
+    void BlockCache::Insert(u64 backingId, size_t block, span<u8> data) {
+        std::scoped_lock lock(mutex);
+        Key key{backingId, block};
+        if (entryMap.contains(key))
+            return;
+
+        while (size + data.size() > Capacity && !entries.empty()) {
+            auto &last{entries.back()};
+            size -= last.data.size();
+            entryMap.erase(last.key);
+            entries.pop_back();
+        }
+
+        entries.push_front(Entry{key, std::vector<u8>(data.begin(), data.end())});
+        entryMap.emplace(key, entries.begin());
+        size += data.size();
+    }
+
+    void BlockCache::RecordRead(size_t readSize, u64 duration) {
+        std::scoped_lock lock(mutex);
+        statistics.bytesRead += readSize;
+        statistics.readDuration += duration;
+    }
+
+    BlockCache::Statistics BlockCache::GetStatistics() {
+        std::scoped_lock lock(mutex);
+        return statistics;
+    }
+
+    CachedBacking::CachedBacking(std::shared_ptr<Backing> pBacking) : Backing(pBacking->mode, pBacking->size), backing(std::move(pBacking)) {
+        if (mode.write || mode.append)
+            throw exception("Cannot cache a writable backing");
+
+        static std::atomic<u64> nextId;
+        id = nextId++;
+    }
+
+    size_t CachedBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (offset >= size)
+            return 0;
+        output = output.first(std::min(output.size(), size - offset));
+
+        // Large reads gain nothing from being cached and would evict a large part of the cache, so they're passed through directly
+        if (output.size() >= MaxReadaheadBlocks * BlockCache::BlockSize)
+            return backing->ReadUnchecked(output, offset);
+
+        auto &cache{BlockCache::Get()};
+        size_t read{};
+        while (read < output.size()) {
+            auto position{offset + read};
+            auto block{position / BlockCache::BlockSize}, blockOffset{position % BlockCache::BlockSize};
+            auto chunk{output.subspan(read, std::min(output.size() - read, BlockCache::BlockSize - blockOffset))};
+
+            if (!cache.Read(id, block, chunk, blockOffset)) {
+                size_t blockCount;
+                {
+                    std::scoped_lock lock(mutex);
+                    if (block == nextBlock) {
+                        blockCount = readaheadBlocks;
+                        readaheadBlocks = std::min(readaheadBlocks * 2, MaxReadaheadBlocks);
+                    } else {
+                        blockCount = 1;
+                        readaheadBlocks = 1;
+                    }
+                    nextBlock = block + blockCount;
+                }
+
+                auto blockStart{block * BlockCache::BlockSize};
+                std::vector<u8> buffer(std::min(blockCount * BlockCache::BlockSize, size - blockStart));
+
+                // Blocks in the readahead window which are already cached are skipped, the first block is always read as it's the one that missed
+                std::vector<ReadRequest> requests;
+                for (size_t bufferOffset{}; bufferOffset < buffer.size(); bufferOffset += BlockCache::BlockSize)
+                    if (!bufferOffset || !cache.Contains(id, block + (bufferOffset / BlockCache::BlockSize)))
+                        requests.push_back(ReadRequest{span(buffer).subspan(bufferOffset, std::min(BlockCache::BlockSize, buffer.size() - bufferOffset)), blockStart + bufferOffset});
+
+                auto startTime{util::GetTimeNs()};
+                backing->ReadBatch(requests);
+                size_t bytesRead{};
+                for (const auto &request : requests)
+                    bytesRead += request.read;
+                cache.RecordRead(bytesRead, util::GetTimeNs() - startTime);
+
+                for (const auto &request : requests)
+                    if (request.read)
+                        cache.Insert(id, request.offset / BlockCache::BlockSize, request.output.first(request.read));
+
+                auto blockRead{requests.front().read};
+                if (blockRead <= blockOffset)
+                    break;
+                std::memcpy(chunk.data(), buffer.data() + blockOffset, std::min(chunk.size(), blockRead - blockOffset));
+            }
+
+            read += chunk.size();
+        }
+
+        return read;
+    }
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <list>
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A size-bounded LRU cache of fixed-size blocks read from backings, it's shared between all CachedBackings
+     */
+    class BlockCache {
+      public:
+        static constexpr size_t BlockSize{0x4000}; //!< The size of a single block in the cache
+        static constexpr size_t Capacity{0x4000000}; //!< The maximum total size of all cached blocks (64MiB)
+
+        struct Statistics {
+            u64 hits; //!< The amount of blocks which were read from the cache
+            u64 misses; //!< The amount of blocks which had to be read from a backing
+            u64 bytesRead; //!< The amount of bytes read from backings to fill the cache, this includes readahead
+            u64 readDuration; //!< The total time spent reading from backings to fill the cache in nanoseconds
+        };
+
+      private:
+        struct Key {
+            u64 backingId;
+            size_t block;
+
+            bool operator==(const Key &) const = default;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key &key) const {
+                return std::hash<u64>{}(key.backingId) ^ (std::hash<size_t>{}(key.block) << 1);
+            }
+        };
+
+        struct Entry {
+            Key key;
+            std::vector<u8> data;
+        };
+
+        std::mutex mutex;
+        std::list<Entry> entries; //!< All cached blocks from the most recently used to the least recently used
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entryMap;
+        size_t size{}; //!< The total size of all cached blocks
+        Statistics statistics{};
+
+        BlockCache() = default;
+
+      public:
+        /**
+         * @return The cache shared between all CachedBackings
+         */
+        static BlockCache &Get() {
+            static BlockCache cache;
+            return cache;
+        }
+
+        /**
+         * @brief Copies a part of a cached block into the supplied buffer
+         * @return If the block was present in the cache
+         */
+        bool Read(u64 backingId, size_t block, span<u8> output, size_t offset);
+
+        /**
+         * @return If the block is present in the cache, this doesn't affect the recency of the block or the statistics
+         */
+        bool Contains(u64 backingId, size_t block);
+
+        /**
+         * @brief Inserts a block into the cache, evicting the least recently used blocks if required
+         */
+        void Insert(u64 backingId, size_t block, span<u8> data);
+
+        /**
+         * @brief Records a read from a backing which was done to fill the cache
+         */
+        void RecordRead(size_t size, u64 duration);
+
+        Statistics GetStatistics();
+    };
+
+    /**
+     * @brief A backing which caches the blocks read from a read-only backing in the shared BlockCache and reads ahead of sequential accesses
+     * @note This is intended for backings with an expensive read path such as RomFS inside an encrypted NCA, as every read from them would otherwise be decrypted separately
+     * @note Readahead is done with a batched read of the blocks which aren't cached yet, backings that support it read the resulting discontiguous runs concurrently
+     */
+    class CachedBacking : public Backing {
+      private:
+        static constexpr size_t MaxReadaheadBlocks{0x10}; //!< The maximum amount of blocks read at once when reads are sequential (256KiB)
+
+        std::shared_ptr<Backing> backing; //!< The backing which reads are cached from
+        u64 id; //!< A unique ID for this backing which is used as a part of the key for blocks in the cache
+        std::mutex mutex; //!< Synchronizes access to the readahead state
+        size_t nextBlock{}; //!< The block following the one last read from the backing, a miss on this block is treated as a sequential read
+        size_t readaheadBlocks{1}; //!< The amount of blocks to read at once on the next sequential miss, this doubles on every sequential miss up to MaxReadaheadBlocks
+
+      protected:
+        size_t ReadImpl(span<u8> output, size_t offset) override;
+
+      public:
+        CachedBacking(std::shared_ptr<Backing> backing);
+    };
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "io_thread_pool.h"
+
+namespace skyline::vfs {
+    void IoThreadPool::Run() {
+        pthread_setname_np(pthread_self(), "Sky-IO");
+        while (true) {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock lock(mutex);
+                condition.wait(lock, [this] { return exit || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    IoThreadPool::IoThreadPool() {
+        for (size_t index{}; index < ThreadCount; index++)
+            threads.emplace_back(&IoThreadPool::Run, this);
+    }
+
+    IoThreadPool::~IoThreadPool() {
+        {
+            std::scoped_lock lock(mutex);
+            exit = true;
+        }
+        condition.notify_all();
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    std::future<void> IoThreadPool::Submit(std::function<void()> function) {
+        std::packaged_task<void()> task(std::move(function));
+        auto future{task.get_future()};
+        {
+            std::scoped_lock lock(mutex);
+            tasks.push(std::move(task));
+        }
+        condition.notify_one();
+        return future;
+    }
+
+    std::vector<span<Backing::ReadRequest>> IoThreadPool::GroupContiguous(span<Backing::ReadRequest> requests, size_t maxGroupSize) {
+        std::vector<span<Backing::ReadRequest>> groups;
+        for (size_t start{}, index{1}; index <= requests.size(); index++) {
+            if (index == requests.size() || index - start == maxGroupSize || requests[index].offset != requests[index - 1].offset + requests[index - 1].output.size()) {
+                groups.push_back(requests.subspan(start, index - start));
+                start = index;
+            }
+        }
+        return groups;
+    }
+
+    void IoThreadPool::ReadGroups(span<span<Backing::ReadRequest>> groups, const std::function<void(span<Backing::ReadRequest>)> &read) {
+        if (groups.empty())
+            return;
+
+        std::vector<std::future<void>> reads;
+        std::exception_ptr exception;
+        try {
+            reads.reserve(groups.size() - 1);
+            for (size_t index{1}; index < groups.size(); index++)
+                reads.push_back(Get().Submit([&read, group = groups[index]] { read(group); }));
+
+            read(groups.front());
+        } catch (...) {
+            exception = std::current_exception(); // This may be from failing to submit a read, any reads which were submitted prior to that are still waited on below
+        }
+
+        // All reads must complete before returning even if one has failed or couldn't be submitted as they reference the read function and the requests
+        for (auto &future : reads) {
+            try {
+                future.get();
+            } catch (...) {
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+}
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <future>
+#include <thread>
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A pool of threads which perform blocking I/O on behalf of other threads, this allows multiple reads to be in flight at once
+     * @note io_uring would avoid the threads entirely but it's blocked for apps by the seccomp and SELinux policies of Android
+     */
+    class IoThreadPool {
+      private:
+        static constexpr size_t ThreadCount{4};
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::queue<std::packaged_task<void()>> tasks;
+        std::vector<std::thread> threads;
+        bool exit{};
+
+        void Run();
+
+        IoThreadPool();
+
+      public:
+        ~IoThreadPool();
+
+        static IoThreadPool &Get() {
+            static IoThreadPool pool;
+            return pool;
+        }
+
+        /**
+         * @return A future which is ready once the supplied function has been run on an I/O thread, it holds any exception thrown by the function
+         */
+        std::future<void> Submit(std::function<void()> function);
+
+        /**
+         * @brief Splits a batch of reads into groups of consecutive requests which are contiguous in the backing
+         * @param maxGroupSize The maximum amount of requests in a single group
+         */
+        static std::vector<span<Backing::ReadRequest>> GroupContiguous(span<Backing::ReadRequest> requests, size_t maxGroupSize);
+
+        /**
+         * @brief Reads every group with the supplied function, the first group is read on the calling thread while the others are in flight on I/O threads
+         * @note This only returns once every group has been read even if one of them failed, the first exception thrown by any of them is rethrown afterwards
+         */
+        static void ReadGroups(span<span<Backing::ReadRequest>> groups, const std::function<void(span<Backing::ReadRequest>)> &read);
+    };
+}
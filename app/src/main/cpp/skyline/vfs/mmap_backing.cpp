@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "io_thread_pool.h"
+#include "mmap_backing.h"
+
+namespace skyline::vfs {
+    MmapBacking::MmapBacking(int fd) : Backing({true, false, false}) {
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo))
+            throw exception("Failed to stat fd: {}", strerror(errno));
+        size = static_cast<size_t>(fileInfo.st_size);
+        if (!size)
+            throw exception("Cannot map an empty file");
+
+        mapping = reinterpret_cast<u8 *>(mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0));
+        if (mapping == MAP_FAILED)
+            throw exception("Failed to map fd: {}", strerror(errno));
+    }
+
+    MmapBacking::~MmapBacking() {
+        munmap(mapping, size);
+    }
+
+    size_t MmapBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (offset >= size)
+            return 0;
+
+        auto readSize{std::min(output.size(), size - offset)};
+        std::memcpy(output.data(), mapping + offset, readSize);
+        return readSize;
+    }
+
+    void MmapBacking::ReadBatchImpl(span<ReadRequest> requests) {
+        auto groups{IoThreadPool::GroupContiguous(requests, std::numeric_limits<size_t>::max())};
+        IoThreadPool::ReadGroups(groups, [this](span<ReadRequest> group) {
+            for (auto &request : group)
+                request.read = ReadImpl(request.output, request.offset);
+        });
+    }
+
+    bool MmapBacking::Advise(const DeviceState &state, AccessPattern pattern) {
+        int advice{[pattern]() {
+            switch (pattern) {
+                case AccessPattern::Normal:
+                    return MADV_NORMAL;
+                case AccessPattern::Sequential:
+                    return MADV_SEQUENTIAL;
+                case AccessPattern::Random:
+                    return MADV_RANDOM;
+            }
+        }()};
+
+        if (madvise(mapping, size, advice) < 0) {
+            state.logger->Warn("Failed to advise the kernel on the access pattern of a mapped file: {}", strerror(errno));
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief The MmapBacking class provides read-only access to a physical linux file by mapping it into memory, reads are a memcpy from the mapping rather than a syscall
+     * @note If the file is truncated or an I/O error occurs while a page of it is faulted in, the access raises SIGBUS on the reading thread rather than returning an error, this isn't handled and will crash the emulator
+     * @note As a result this should only be used for files which won't be modified while they're mapped, such as ROMs supplied by the frontend, and OsBacking should be used otherwise
+     */
+    class MmapBacking : public Backing {
+      private:
+        u8 *mapping; //!< A read-only mapping of the entire file
+
+      protected:
+        size_t ReadImpl(span<u8> output, size_t offset) override;
+
+        /**
+         * @note Copies from the mapping block on page faults which read the file, runs of contiguous requests are copied concurrently on I/O threads so the faults of separate runs are serviced in parallel
+         */
+        void ReadBatchImpl(span<ReadRequest> requests) override;
+
+      public:
+        /**
+         * @brief The expected pattern of accesses to the backing, this is used to hint the kernel on how much it should read ahead
+         */
+        enum class AccessPattern {
+            Normal,
+            Sequential,
+            Random,
+        };
+
+        /**
+         * @param fd The file descriptor of the backing, it isn't required to stay open after this returns
+         */
+        MmapBacking(int fd);
+
+        ~MmapBacking();
+
+        /**
+         * @return A span over the contents of the backing which can be used directly instead of reading into a buffer
+         * @note The span is read-only, writing to it will result in a SIGSEGV
+         */
+        span<u8> GetSpan() {
+            return span(mapping, size);
+        }
+
+        /**
+         * @brief Hints the kernel on how the backing will be accessed, this only affects performance
+         * @return If the hint was applied, a failure is logged but otherwise ignored as the backing is still fully functional
+         */
+        bool Advise(const DeviceState &state, AccessPattern pattern);
+    };
+}
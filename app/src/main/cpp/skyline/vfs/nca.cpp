@@ -4,6 +4,7 @@
 #include <crypto/aes_cipher.h>
 #include <loader/loader.h>
 
+#include "cached_backing.h"
 #include "ctr_encrypted_backing.h"
 #include "region_backing.h"
 #include "partition_filesystem.h"
@@ -66,7 +67,7 @@ namespace skyline::vfs {
         size_t offset{static_cast<size_t>(entry.startOffset) * constant::MediaUnitSize + sectionHeader.integrityHashInfo.levels.back().offset};
         size_t size{sectionHeader.integrityHashInfo.levels.back().size};
 
-        romFs = CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset);
+        romFs = std::make_shared<CachedBacking>(CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset)); // RomFS is read in small pieces by most titles, caching them avoids decrypting the same data repeatedly
     }
 
     std::shared_ptr<Backing> NCA::CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset) {
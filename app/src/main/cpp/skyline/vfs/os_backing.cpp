@@ -3,7 +3,9 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#include "io_thread_pool.h"
 #include "os_backing.h"
 
 namespace skyline::vfs {
@@ -28,6 +30,33 @@ namespace skyline::vfs {
         return static_cast<size_t>(ret);
     }
 
+    void OsBacking::ReadBatchImpl(span<ReadRequest> requests) {
+        if (requests.empty())
+            return;
+
+        auto readRequests{[this](span<ReadRequest> group) {
+            std::vector<iovec> vectors;
+            vectors.reserve(group.size());
+            for (auto &request : group)
+                vectors.push_back(iovec{request.output.data(), request.output.size()});
+
+            auto ret{preadv64(fd, vectors.data(), static_cast<int>(vectors.size()), static_cast<off64_t>(group.front().offset))};
+            if (ret < 0)
+                throw exception("Failed to read from fd: {}", strerror(errno));
+
+            // The bytes read are distributed across the requests in order as a vectored read fills each buffer completely before moving to the next one
+            auto remaining{static_cast<size_t>(ret)};
+            for (auto &request : group) {
+                request.read = std::min(remaining, request.output.size());
+                remaining -= request.read;
+            }
+        }};
+
+        // Contiguous requests are grouped into a single vectored read, IOV_MAX limits the amount of buffers in each group
+        auto groups{IoThreadPool::GroupContiguous(requests, IOV_MAX)};
+        IoThreadPool::ReadGroups(groups, readRequests);
+    }
+
     size_t OsBacking::WriteImpl(span<u8> input, size_t offset) {
         auto ret{pwrite64(fd, input.data(), input.size(), offset)};
         if (ret < 0)
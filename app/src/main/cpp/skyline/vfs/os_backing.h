@@ -17,6 +17,11 @@ namespace skyline::vfs {
       protected:
         size_t ReadImpl(span<u8> output, size_t offset) override;
 
+        /**
+         * @note Requests which are contiguous in the file are coalesced into a single vectored read, the resulting reads are spread across a pool of I/O threads so they're in flight concurrently
+         */
+        void ReadBatchImpl(span<ReadRequest> requests) override;
+
         size_t WriteImpl(span<u8> input, size_t offset) override;
 
         void ResizeImpl(size_t size) override;
@@ -19,6 +19,24 @@ namespace skyline::vfs {
             return backing->ReadUnchecked(output, baseOffset + offset);
         }
 
+        void ReadBatchImpl(span<ReadRequest> requests) override {
+            // The offsets are restored even if the parent throws as the requests are owned by the caller
+            struct OffsetGuard {
+                span<ReadRequest> requests;
+                size_t offset;
+
+                ~OffsetGuard() {
+                    for (auto &request : requests)
+                        request.offset -= offset;
+                }
+            };
+
+            for (auto &request : requests)
+                request.offset += baseOffset;
+            OffsetGuard guard{requests, baseOffset};
+            backing->ReadBatch(requests);
+        }
+
       public:
         /**
          * @param file The backing to create the RegionBacking from
@@ -14,6 +14,7 @@ import android.net.Uri
 import android.os.*
 import android.util.Log
 import android.view.*
+import android.widget.Toast
 import androidx.appcompat.app.AppCompatActivity
 import androidx.core.view.isGone
 import androidx.core.view.isInvisible
@@ -77,6 +78,20 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
      */
     private external fun stopEmulation() : Boolean
 
+    /**
+     * Captures the memory and CPU state of the guest process, this replaces any previously saved state
+     *
+     * @return If the state was successfully saved
+     */
+    private external fun saveState() : Boolean
+
+    /**
+     * Restores the guest process to the state captured by the last call to [saveState]
+     *
+     * @return If the state was successfully loaded
+     */
+    private external fun loadState() : Boolean
+
     /**
      * This sets the surface object in libskyline to the provided value, emulation is halted if set to null
      *
@@ -317,6 +332,20 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
             else -> return super.dispatchKeyEvent(event)
         }
 
+        when (event.keyCode) {
+            KeyEvent.KEYCODE_F5 -> {
+                if (action == ButtonState.Pressed)
+                    Toast.makeText(this, if (saveState()) "Saved state" else "Failed to save state", Toast.LENGTH_SHORT).show()
+                return true
+            }
+
+            KeyEvent.KEYCODE_F9 -> {
+                if (action == ButtonState.Pressed)
+                    Toast.makeText(this, if (loadState()) "Loaded state" else "Failed to load state", Toast.LENGTH_SHORT).show()
+                return true
+            }
+        }
+
         return when (val guestEvent = inputManager.eventMap[KeyHostEvent(event.device.descriptor, event.keyCode)]) {
             is ButtonGuestEvent -> {
                 if (guestEvent.button != ButtonId.Menu)